@@ -0,0 +1,202 @@
+/*
+ * Benchmark.cpp
+ * VORTRAC
+ *
+ */
+
+#include <iostream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "Benchmark.h"
+#include "ChooseCenter.h"
+#include "DataObjects/GriddedFactory.h"
+#include "DataObjects/SimplexList.h"
+#include "DataObjects/VortexData.h"
+#include "NRL/RadarQC.h"
+#include "Pressure/PressureList.h"
+#include "Radar/AnalyticRadar.h"
+#include "Threads/SimplexThread.h"
+#include "Threads/VortexThread.h"
+
+Benchmark::Benchmark(const QString &configFile, const QString &analyticFile)
+{
+    this->configFile = configFile;
+    this->analyticFile = analyticFile;
+
+    // Gates per ray, sweeps, beam width (deg) and CAPPI spacing (km).
+    // AnalyticRadar only knows the elevation angles of up to 6 sweeps.
+    BenchCase small   = { "small",  150, 3, 1.0f,  1.0f };
+    BenchCase medium  = { "medium", 250, 5, 1.0f,  0.5f };
+    BenchCase large   = { "large",  460, 6, 0.5f, 0.25f };
+    cases << small << medium << large;
+}
+
+bool Benchmark::run(const QString &outputFile)
+{
+    // Each file on its own, a read merges into whatever is already loaded
+    Configuration checkConfig;
+    if (!checkConfig.read(configFile)) {
+        std::cerr << "Benchmark: could not read " << configFile.toStdString() << std::endl;
+        return false;
+    }
+    Configuration checkAnalytic;
+    if (!checkAnalytic.read(analyticFile)) {
+        std::cerr << "Benchmark: could not read " << analyticFile.toStdString() << std::endl;
+        return false;
+    }
+
+    QJsonArray results;
+    for (int i = 0; i < cases.size(); i++) {
+        std::cout << "Benchmark case " << cases.at(i).name.toStdString() << " ..." << std::endl;
+        results.append(runCase(cases.at(i)));
+    }
+
+    QJsonObject report;
+    report["config"] = QFileInfo(configFile).absoluteFilePath();
+    report["analytic"] = QFileInfo(analyticFile).absoluteFilePath();
+    report["cases"] = results;
+    QByteArray json = QJsonDocument(report).toJson();
+
+    std::cout << json.constData() << std::endl;
+    QFile out(outputFile);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "Benchmark: could not write " << outputFile.toStdString() << std::endl;
+        return false;
+    }
+    out.write(json);
+    out.close();
+    return true;
+}
+
+QJsonObject Benchmark::runCase(const BenchCase &bench)
+{
+    // Fresh copies of both configurations, resized for this case
+    Configuration config;
+    config.read(configFile);
+    QDomElement cappi = config.getConfig("cappi");
+    float xExtent = config.getParam(cappi, "xdim").toFloat() * config.getParam(cappi, "xgridsp").toFloat();
+    float yExtent = config.getParam(cappi, "ydim").toFloat() * config.getParam(cappi, "ygridsp").toFloat();
+    int xDim = qMin(int(xExtent / bench.gridSpacing), GriddedData::getMaxIDim());
+    int yDim = qMin(int(yExtent / bench.gridSpacing), GriddedData::getMaxJDim());
+    config.setParam(cappi, "xdim", QString().setNum(xDim));
+    config.setParam(cappi, "ydim", QString().setNum(yDim));
+    config.setParam(cappi, "xgridsp", QString().setNum(bench.gridSpacing));
+    config.setParam(cappi, "ygridsp", QString().setNum(bench.gridSpacing));
+
+    Configuration analytic;
+    analytic.read(analyticFile);
+    QDomElement analyticRadar = analytic.getConfig("analytic_radar");
+    analytic.setParam(analyticRadar, "sample", "true");
+    analytic.setParam(analyticRadar, "dealiasdata", "true");
+    analytic.setParam(analyticRadar, "numgates", QString().setNum(bench.numGates));
+    analytic.setParam(analyticRadar, "numsweeps", QString().setNum(bench.numSweeps));
+    analytic.setParam(analyticRadar, "beamwidth", QString().setNum(bench.beamWidth));
+    QString caseFile = QDir::temp().filePath("vortrac_benchmark_" + bench.name + ".xml");
+    analytic.write(caseFile);
+
+    QDomElement vortex = config.getConfig("vortex");
+    float vortexLat = config.getParam(vortex, "lat").toFloat();
+    float vortexLon = config.getParam(vortex, "lon").toFloat();
+    const RadarParams& radarParams = config.getRadarParams();
+
+    StageStats stats;
+    StageStats::setActive(&stats);
+    QElapsedTimer total;
+    total.start();
+
+    AnalyticRadar *radar = new AnalyticRadar("Analytic", radarParams.lat, radarParams.lon, caseFile);
+    radar->setConfigElement(&config);
+    {
+        StageTimer timer("decode");
+        radar->readVolume();
+    }
+    long gates = 0;
+    for (int n = 0; n < radar->getNumRays(); n++)
+        gates += radar->getRay(n)->getRef_numgates() + radar->getRay(n)->getVel_numgates();
+
+    // The remaining stages time themselves
+    RadarQC qc(radar);
+    qc.getConfig(config.getConfig("qc"));
+    qc.dealias();
+
+    GriddedFactory factory;
+    GriddedData *gridData = factory.makeCappi(radar, &config, &vortexLat, &vortexLon);
+    long cells = long(gridData->getIdim()) * long(gridData->getJdim()) * long(gridData->getKdim());
+
+    SimplexList simplexList;
+    VortexData *vortexData = new VortexData();
+    vortexData->setTime(radar->getDateTime());
+    SimplexThread simplex;
+    simplex.initParam(&config, gridData, vortexLat, vortexLon);
+    simplex.findCenter(&simplexList);
+
+    // Same level choice as workThread::findCenter
+    int bestLevel = -1;
+    int maxConverged = 0;
+    if (!simplexList.isEmpty()) {
+        simplexList.last().setTime(vortexData->getTime());
+        for (int level = 0; level < simplexList.last().getNumLevels(); level++) {
+            int converged = 0;
+            for (int r = 0; r < simplexList.last().getNumRadii(); r++)
+                if (simplexList.last().getNumConvergingCenters(level, r) > 0)
+                    converged++;
+            if (converged > maxConverged) {
+                maxConverged = converged;
+                bestLevel = level;
+            }
+        }
+    }
+
+    if (bestLevel >= 0) {
+        ChooseCenter centerFinder(&config, &simplexList, vortexData);
+        centerFinder.findCenter(bestLevel);
+        vortexData->setBestLevel(bestLevel);
+
+        PressureList pressureList;
+        VortexThread vtd;
+        vtd.getWinds(&config, gridData, radar, vortexData, &pressureList);
+    } else {
+        std::cout << "Benchmark case " << bench.name.toStdString()
+                  << ": no converged center, VTD stages skipped" << std::endl;
+    }
+
+    qint64 totalNsecs = total.nsecsElapsed();
+    StageStats::setActive(NULL);
+
+    QJsonObject result;
+    result["name"] = bench.name;
+    result["gates_per_ray"] = bench.numGates;
+    result["sweeps"] = bench.numSweeps;
+    result["beamwidth"] = bench.beamWidth;
+    result["grid_spacing_km"] = bench.gridSpacing;
+    result["grid_cells"] = double(cells);
+    result["gates"] = double(gates);
+    result["center_found"] = bestLevel >= 0;
+    result["stages"] = stats.toJson();
+    result["counters"] = stats.countersToJson();
+    result["total_ms"] = totalNsecs / 1.0e6;
+
+    QJsonObject throughput;
+    if (stats.getMilliseconds("decode") > 0)
+        throughput["decode_gates_per_s"] = gates / (stats.getMilliseconds("decode") / 1000.);
+    if (stats.getMilliseconds("qc") > 0)
+        throughput["qc_gates_per_s"] = gates / (stats.getMilliseconds("qc") / 1000.);
+    if (stats.getMilliseconds("gridding") > 0)
+        throughput["gridding_cells_per_s"] = cells / (stats.getMilliseconds("gridding") / 1000.);
+    if (totalNsecs > 0)
+        throughput["volumes_per_s"] = 1.0e9 / totalNsecs;
+    result["throughput"] = throughput;
+    result["peak_rss_kb"] = double(StageStats::peakRss());
+
+    delete vortexData;
+    delete gridData;
+    delete radar;
+    QFile::remove(caseFile);
+
+    return result;
+}
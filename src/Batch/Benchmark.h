@@ -0,0 +1,49 @@
+/*
+ * Benchmark.h
+ * VORTRAC
+ *
+ * Runs synthetic volumes from AnalyticRadar through the whole analysis
+ * at several sizes and reports the time spent in each stage. Nothing is
+ * displayed and no lists are saved, so runs are comparable across builds.
+ *
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+
+#include "Config/Configuration.h"
+#include "IO/StageStats.h"
+
+class Benchmark
+{
+
+public:
+    // configFile is a regular VORTRAC configuration, analyticFile the
+    // analytic storm and radar description sampled for each case
+    Benchmark(const QString &configFile, const QString &analyticFile);
+
+    // Runs every case and writes the report to outputFile as JSON.
+    // Returns false if the configurations could not be read.
+    bool run(const QString &outputFile);
+
+private:
+    struct BenchCase {
+        QString name;
+        int numGates;
+        int numSweeps;
+        float beamWidth;
+        float gridSpacing;
+    };
+
+    QJsonObject runCase(const BenchCase &bench);
+
+    QString configFile;
+    QString analyticFile;
+    QList<BenchCase> cases;
+};
+
+#endif
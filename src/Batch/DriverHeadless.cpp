@@ -0,0 +1,173 @@
+/*
+ * DriverHeadless.cpp
+ * VORTRAC
+ *
+ */
+
+#include <QTimer>
+#include <iostream>
+
+#include "DriverHeadless.h"
+
+DriverHeadless::DriverHeadless(QObject *parent, const QString &fileName)
+    : QObject(parent)
+{
+    this->setObjectName("Headless Driver");
+    xmlfile = fileName;
+
+    statusLog = new Log();
+    connect(this, SIGNAL(log(const Message&)),statusLog, SLOT(catchLog(const Message&)));
+
+    configData = new Configuration;
+    connect(configData, SIGNAL(log(const Message&)),this, SLOT(catchLog(const Message&)));
+
+    statusLog->catchLog(Message("VORTRAC Status Log for "+QDateTime::currentDateTime().toUTC().toString()+ " UTC"));
+
+    pollThread = NULL;
+    thread = NULL;
+    atcf = NULL;
+    madis = NULL;
+    fetchremote = NULL;
+}
+
+DriverHeadless::~DriverHeadless()
+{
+    if (thread) {
+        if (pollThread)
+            pollThread->stop();
+        thread->quit();
+        thread->wait();
+        delete pollThread;
+        delete thread;
+    }
+    delete atcf;
+    delete madis;
+    delete fetchremote;
+    delete configData;
+    delete statusLog;
+}
+
+bool DriverHeadless::initialize()
+{
+    return loadFile(xmlfile);
+}
+
+bool DriverHeadless::run()
+{
+    // workThread has no parent here, so it really runs on its own thread.
+    // Nothing listens to the CAPPI signals, so no image is ever built.
+    thread = new QThread;
+    pollThread = new workThread();
+    pollThread->setBatchMode(true);
+    pollThread->moveToThread(thread);
+
+    connect(thread, SIGNAL(started()), pollThread, SLOT(run()));
+    connect(pollThread, SIGNAL(finished()), thread, SLOT(quit()));
+    connect(thread, SIGNAL(finished()), this, SLOT(analysisFinished()));
+    connect(pollThread, SIGNAL(log(const Message&)),this, SLOT(catchLog(const Message&)));
+
+    atcf = new ATCF(configData);
+    connect(atcf, SIGNAL(log(const Message&)),this, SLOT(catchLog(const Message&)));
+    connect(atcf, SIGNAL(tcvitalsReady()),this, SLOT(updateTcvitals()));
+    pollThread->setATCF(atcf);
+
+    madis = new MADISFactory(configData);
+    connect(madis, SIGNAL(log(const Message&)),this, SLOT(catchLog(const Message&)));
+
+    fetchremote = new FetchRemote(configData);
+    connect(fetchremote, SIGNAL(log(const Message&)),this, SLOT(catchLog(const Message&)));
+
+    // Same schedule as DriverBatch: fetch radar data every 5 minutes,
+    // TC vitals every hour and MADIS pressure every 30 minutes
+    QString mode = configData->getParam(configData->getConfig("vortex"), "mode");
+    if (mode == "operational") {
+        QTimer::singleShot(0, fetchremote, SLOT(fetchRemoteData()));
+        QTimer *fetchTimer = new QTimer(this);
+        connect(fetchTimer, SIGNAL(timeout()), fetchremote, SLOT(fetchRemoteData()));
+        fetchTimer->start(300000);
+
+        QTimer::singleShot(0, atcf, SLOT(getTcvitals()));
+        QTimer *atcfTimer = new QTimer(this);
+        connect(atcfTimer, SIGNAL(timeout()), atcf, SLOT(getTcvitals()));
+        atcfTimer->start(3600000);
+
+        QTimer::singleShot(0, madis, SLOT(getPressureObs()));
+        QTimer *madisTimer = new QTimer(this);
+        connect(madisTimer, SIGNAL(timeout()), madis, SLOT(getPressureObs()));
+        madisTimer->start(1800000);
+    } else {
+        startAnalysis();
+    }
+    return true;
+}
+
+void DriverHeadless::startAnalysis()
+{
+    if (thread->isRunning())
+        return;
+    pollThread->setContinuePreviousRun(false);
+    pollThread->setConfig(configData);
+    thread->start();
+}
+
+void DriverHeadless::catchLog(const Message& message)
+{
+    emit log(message);
+}
+
+void DriverHeadless::analysisFinished()
+{
+    std::cout << "Finalizing ...\n";
+    emit finished();
+}
+
+bool DriverHeadless::loadFile(const QString &fileName)
+{
+    std::cout << "Loading xml file ...\n";
+    if (!configData->read(fileName)) {
+        emit log(Message(QString("Couldn't load configuration file"),0,this->objectName()));
+        return false;
+    }
+
+    QString directoryString(configData->getParam(configData->getConfig("vortex"),
+                                                 "dir"));
+    workingDirectory = QDir(directoryString);
+    if(!workingDirectory.isAbsolute()) {
+        workingDirectory.makeAbsolute();
+    }
+    if(!workingDirectory.exists())
+        if(!workingDirectory.mkpath(directoryString)) {
+            emit log(Message(QString("Failed to find or create working directory path: "+directoryString),0,this->objectName()));
+            return false;
+        }
+    statusLog->setWorkingDirectory(workingDirectory);
+    return true;
+}
+
+void DriverHeadless::updateTcvitals()
+{
+    // As DriverBatch::updateTcvitals, without the configuration dialog.
+    // Configuration::read already validated the rest of the file.
+    QDomElement vortex = configData->getConfig("vortex");
+    configData->setParam(vortex, "name", atcf->getStormName());
+    configData->setParam(vortex, "lat", QString().setNum(atcf->getLatitude(atcf->getTime())));
+    configData->setParam(vortex, "lon", QString().setNum(atcf->getLongitude(atcf->getTime())));
+    configData->setParam(vortex, "direction", QString().setNum(atcf->getDirection()));
+    configData->setParam(vortex, "speed", QString().setNum(atcf->getSpeed()));
+    configData->setParam(vortex, "rmw", QString().setNum(atcf->getRMW()));
+    QString date = atcf->getTime().toString("yyyy-MM-dd");
+    QString time = atcf->getTime().toString("hh:mm:ss");
+    configData->setParam(vortex, "obsdate", date);
+    configData->setParam(vortex, "obstime", time);
+
+    QDomElement radar = configData->getConfig("radar");
+    configData->setParam(radar, "startdate", date);
+    configData->setParam(radar, "starttime", time);
+
+    QDomElement choosecenter = configData->getConfig("choosecenter");
+    configData->setParam(choosecenter, "startdate", date);
+    configData->setParam(choosecenter, "starttime", time);
+
+    // Operational runs start once the storm is known
+    startAnalysis();
+}
@@ -0,0 +1,64 @@
+/*
+ * DriverHeadless.h
+ * VORTRAC
+ *
+ * Batch driver for nodes without a display. It runs the same analysis as
+ * DriverBatch under a QCoreApplication, without building any widgets or
+ * CAPPI images. Results go to the status log and the usual output files.
+ *
+ */
+
+#ifndef DRIVERHEADLESS_H
+#define DRIVERHEADLESS_H
+
+#include <QObject>
+#include <QThread>
+#include <QDir>
+
+#include "Config/Configuration.h"
+#include "Threads/workThread.h"
+#include "IO/Log.h"
+#include "IO/Message.h"
+#include "IO/ATCF.h"
+#include "Pressure/MADISFactory.h"
+#include "Radar/FetchRemote.h"
+
+class DriverHeadless : public QObject
+{
+    Q_OBJECT
+
+public:
+    DriverHeadless(QObject *parent, const QString &fileName);
+    ~DriverHeadless();
+    bool initialize();
+    bool run();
+
+public slots:
+    void catchLog(const Message& message);
+
+private slots:
+    void updateTcvitals();
+    void analysisFinished();
+
+signals:
+    void log(const Message& message);
+    void finished();
+
+private:
+    bool loadFile(const QString &fileName);
+    void startAnalysis();
+
+    QString xmlfile;
+    QDir workingDirectory;
+    Configuration *configData;
+    Log *statusLog;
+
+    workThread *pollThread;
+    QThread *thread;
+
+    ATCF *atcf;
+    MADISFactory *madis;
+    FetchRemote *fetchremote;
+};
+
+#endif // DRIVERHEADLESS_H
@@ -0,0 +1,59 @@
+/*
+ * DriverMultiStorm.cpp
+ * VORTRAC
+ *
+ */
+
+#include <iostream>
+
+#include "DriverMultiStorm.h"
+
+DriverMultiStorm::DriverMultiStorm(QObject *parent, const QStringList &fileNames,
+                                   int slots, VolumeScheduler::Policy policy)
+    : QObject(parent), scheduler(slots, policy)
+{
+    this->setObjectName("Multi Storm Driver");
+    xmlfiles = fileNames;
+    running = 0;
+}
+
+DriverMultiStorm::~DriverMultiStorm()
+{
+    // Stop every storm before the scheduler they wait on goes away
+    for (int i = 0; i < drivers.size(); i++)
+        delete drivers.at(i);
+    VolumeScheduler::setActive(NULL);
+}
+
+bool DriverMultiStorm::initialize()
+{
+    for (int i = 0; i < xmlfiles.size(); i++) {
+        DriverHeadless *driver = new DriverHeadless(0, xmlfiles.at(i));
+        drivers.append(driver);
+        if (!driver->initialize()) {
+            std::cout << "Could not load " << xmlfiles.at(i).toStdString() << "\n";
+            return false;
+        }
+        connect(driver, SIGNAL(finished()), this, SLOT(stormFinished()));
+    }
+    return true;
+}
+
+bool DriverMultiStorm::run()
+{
+    std::cout << "Running " << drivers.size() << " storms, "
+              << scheduler.getSlots() << " volume(s) at a time\n";
+    VolumeScheduler::setActive(&scheduler);
+    running = drivers.size();
+    for (int i = 0; i < drivers.size(); i++)
+        drivers.at(i)->run();
+    return true;
+}
+
+void DriverMultiStorm::stormFinished()
+{
+    if (--running > 0)
+        return;
+    std::cout << "Finished all storms\n";
+    emit finished();
+}
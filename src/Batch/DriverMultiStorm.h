@@ -0,0 +1,46 @@
+/*
+ * DriverMultiStorm.h
+ * VORTRAC
+ *
+ * Headless batch run over several storm configurations in one process.
+ * Each storm gets its own DriverHeadless (status log, output files and
+ * analysis thread), and the storms take turns on the machine through a
+ * shared VolumeScheduler.
+ *
+ */
+
+#ifndef DRIVERMULTISTORM_H
+#define DRIVERMULTISTORM_H
+
+#include <QObject>
+#include <QStringList>
+#include <QList>
+
+#include "Batch/DriverHeadless.h"
+#include "Threads/VolumeScheduler.h"
+
+class DriverMultiStorm : public QObject
+{
+    Q_OBJECT
+
+public:
+    DriverMultiStorm(QObject *parent, const QStringList &fileNames,
+                     int slots, VolumeScheduler::Policy policy);
+    ~DriverMultiStorm();
+    bool initialize();
+    bool run();
+
+private slots:
+    void stormFinished();
+
+signals:
+    void finished();
+
+private:
+    QStringList xmlfiles;
+    QList<DriverHeadless*> drivers;
+    VolumeScheduler scheduler;
+    int running;
+};
+
+#endif // DRIVERMULTISTORM_H
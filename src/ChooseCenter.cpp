@@ -11,6 +11,7 @@
 
 #include "ChooseCenter.h"
 #include "Math/Matrix.h"
+#include "IO/StageStats.h"
 #include <math.h>
 #include <QDomElement>
 #include <QHash>
@@ -118,6 +119,8 @@ bool ChooseCenter::findCenter(int level)
      * the recent 2 hours is needed to do this fitting. before performing the fitting, a average center is
      * compute, if the polynomial fitting fails or there is not enough history data, this average center is used.
      */
+    StageTimer timer("choosecenter");
+    StageStats::count("choosecenter_volumes", _simplexResults->size());
     _initialize();
 
     if(!_calMeanCenters()) {
@@ -293,7 +296,7 @@ bool ChooseCenter::_calMeanCenters()
             float bestWind = 0.0;
             float bestStd = 50.;
             float bestPts = 0.;
-            float ptRatio = (float)_simplexResults->at(vidx).getNumPointsUsed() / 2.718281828;
+            float ptRatio = (float)_simplexResults->at(vidx).getNumPointsRefined() / 2.718281828;
 
             //get array of maxwind,centerSD,convegedPoints on this level, and calculate best value of these param
             for(int ridx = 0; ridx < NRADII; ridx++) {
@@ -17,6 +17,8 @@ Configuration::Configuration(QObject *parent, const QString &filename) : QObject
 {
     this->setObjectName("Configuration");
     logChanges = false;
+    updateParams();
+    connect(this, SIGNAL(configChanged()), this, SLOT(updateParams()));
     if(filename.isEmpty())
     { // Create a new configuration from scratch
         QDomDocument domDoc("CurrConfig");
@@ -86,6 +88,7 @@ bool Configuration::read(const QString &filename)
         indexForTagName.insert(group.tagName(), i);
     }
     isModified = false;
+    updateParams();
     return true;
 }
 
@@ -594,6 +597,7 @@ Configuration& Configuration::operator = (const Configuration &other)
     groupList = other.groupList;
     indexForTagName = other.indexForTagName;
     isModified = other.isModified;
+    updateParams();
     return *this;
 
 }
@@ -625,6 +629,72 @@ QString Configuration::findConfigNameStartsWith(const QString& name)
     return realName;
 }
 
+void Configuration::updateParams()
+{
+    // Refresh the typed parameter copies, missing sections read as zero
+
+    radarParams = RadarParams();
+    radarParams.lat = radarParams.lon = radarParams.alt = 0;
+    if(indexForTagName.contains("radar")) {
+        QDomElement radar = getConfig("radar");
+        radarParams.lat = getParam(radar, "lat").toFloat();
+        radarParams.lon = getParam(radar, "lon").toFloat();
+        radarParams.alt = getParam(radar, "alt").toFloat();
+    }
+
+    readRingParams("center", centerParams);
+    readRingParams("vtd", vtdParams);
+
+    pressureParams = PressureParams();
+    pressureParams.maxObsTime = pressureParams.maxObsDist = 0;
+    pressureParams.numErrorPoints = 0;
+    if(indexForTagName.contains("pressure")) {
+        QDomElement pressure = getConfig("pressure");
+        pressureParams.maxObsTime = getParam(pressure, "maxobstime").toFloat();
+        pressureParams.maxObsDist = getParam(pressure, "maxobsdist").toFloat();
+        pressureParams.maxObsMethod = getParam(pressure, "maxobsmethod");
+        pressureParams.gradientHeight = getParam(pressure, "gradient_height");
+        pressureParams.numErrorPoints = getParam(pressure, "uncertaintypoints").toInt();
+    }
+}
+
+void Configuration::readRingParams(const QString &configName, RingParams &params)
+{
+    params = RingParams();
+    params.bottomLevel = params.topLevel = 0;
+    params.innerRadius = params.outerRadius = params.ringWidth = 0;
+    params.maxWaveNumber = 0;
+    params.influenceRadius = params.convergence = params.maxIterations = 0;
+    params.boxDiameter = params.numPoints = 0;
+    params.survivors = 0;
+    if(!indexForTagName.contains(configName))
+        return;
+
+    QDomElement element = getConfig(configName);
+    params.geometry = getParam(element, "geometry");
+    params.closure = getParam(element, "closure");
+    params.velocity = getParam(element, "velocity");
+    params.bottomLevel = getParam(element, "bottomlevel").toFloat();
+    params.topLevel = getParam(element, "toplevel").toFloat();
+    params.innerRadius = getParam(element, "innerradius").toFloat();
+    params.outerRadius = getParam(element, "outerradius").toFloat();
+    params.ringWidth = getParam(element, "ringwidth").toFloat();
+    params.maxWaveNumber = getParam(element, "maxwavenumber").toInt();
+    for(int i = 0; i <= params.maxWaveNumber; i++)
+        params.maxDataGap.append(getParam(element, "maxdatagap", "wavenum",
+                                          QString().setNum(i)).toFloat());
+
+    if(configName == "center") {
+        params.influenceRadius = getParam(element, "influenceradius").toFloat();
+        params.convergence = getParam(element, "convergence").toFloat();
+        params.maxIterations = getParam(element, "maxiterations").toFloat();
+        params.boxDiameter = getParam(element, "boxdiameter").toFloat();
+        params.numPoints = getParam(element, "numpoints").toFloat();
+        params.searchMode = getParam(element, "searchmode");
+        params.survivors = getParam(element, "survivors").toInt();
+    }
+}
+
 bool Configuration::validate()
 {
     //Basic check to see if this is really a configuration file
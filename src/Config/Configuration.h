@@ -17,8 +17,54 @@
 #include <QFile>
 #include <QTextStream>
 #include <QHash>
+#include <QList>
 #include "IO/Message.h"
 
+/*
+ * Typed copies of the parameters that the analysis reads for every volume
+ * or level. They are rebuilt from the DOM whenever the configuration is read
+ * or changed, so the analysis never walks the tree or parses strings there.
+ */
+
+struct RadarParams
+{
+    float lat;
+    float lon;
+    float alt;
+};
+
+// Shared by the center (simplex) and vtd sections
+struct RingParams
+{
+    QString geometry;
+    QString closure;
+    QString velocity;
+    float bottomLevel;
+    float topLevel;
+    float innerRadius;
+    float outerRadius;
+    float ringWidth;
+    int maxWaveNumber;
+    QList<float> maxDataGap;    // indexed by wavenumber
+    // Simplex only, zero for the vtd section
+    float influenceRadius;
+    float convergence;
+    float maxIterations;
+    float boxDiameter;
+    float numPoints;
+    QString searchMode;         // "full" (default) or "coarse"
+    int survivors;              // starting points refined in coarse mode
+};
+
+struct PressureParams
+{
+    float maxObsTime;          // minutes
+    float maxObsDist;          // km
+    QString maxObsMethod;
+    QString gradientHeight;    // empty if not configured
+    int numErrorPoints;        // perturbed centers for the uncertainty
+};
+
 class Configuration:public QObject
 {
 
@@ -67,6 +113,11 @@ public:
 
     QString findConfigNameStartsWith(const QString& name);
 
+    const RadarParams& getRadarParams() const { return radarParams; }
+    const RingParams& getCenterParams() const { return centerParams; }
+    const RingParams& getVtdParams() const { return vtdParams; }
+    const PressureParams& getPressureParams() const { return pressureParams; }
+
 public slots:
     void catchLog(const Message& message);
 
@@ -115,6 +166,16 @@ private:
   bool isModified;
   bool logChanges;
 
+  RadarParams radarParams;
+  RingParams centerParams;
+  RingParams vtdParams;
+  PressureParams pressureParams;
+
+  void readRingParams(const QString &configName, RingParams &params);
+
+private slots:
+  void updateParams();
+
 signals:
     void log(const Message& message) const;
     void configChanged();
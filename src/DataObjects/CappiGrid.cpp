@@ -14,6 +14,11 @@
 #include <QTextStream>
 #include <QFile>
 #include <QDir>
+#include <QThreadPool>
+#include "IO/StageStats.h"
+#include "Threads/VolumeScheduler.h"
+#include <algorithm>
+#include <vector>
 #if QT_VERSION >= 0x060000
 using namespace Qt;
 #endif
@@ -27,6 +32,7 @@ CappiGrid::CappiGrid() : GriddedData()
     // To make the cappi bigger but still compute it in a reasonable amount of time,
     // skip the reflectivity grid, otherwise set this to true
     gridReflectivity = true;
+    maxElevation = 91;
 }
 
 CappiGrid::~CappiGrid()
@@ -100,16 +106,65 @@ void CappiGrid::gridRadarData(RadarData *radarData, QDomElement cappiConfig,floa
 
     delete[] relDist;
 
+    // Rays from here up only reach above the grid
+    maxElevation = topElevation(radarData, cappiConfig, vortexLat, vortexLon);
+
     // Interpolate the data depending on method chosen
+    StageTimer timer("gridding");
+    StageStats::count("grid_cells", qint64(iDim) * qint64(jDim) * qint64(kDim));
     QString interpolation = cappiConfig.firstChildElement("interpolation").text();
     if (interpolation == "cressman") {
         CressmanInterpolation(radarData);
+    } else if (interpolation == "barnes") {
+        BarnesInterpolation(radarData, cappiConfig);
     }
 
     // Set the initial field names
     fieldNames << "DZ" << "VE" << "HT";
 }
 
+float CappiGrid::topElevation(RadarData *radarData, QDomElement cappiConfig,
+                              float *vortexLat, float *vortexLon)
+{
+    float xDim = cappiConfig.firstChildElement("xdim").text().toFloat();
+    float yDim = cappiConfig.firstChildElement("ydim").text().toFloat();
+    float zDim = cappiConfig.firstChildElement("zdim").text().toFloat();
+    float xSp = cappiConfig.firstChildElement("xgridsp").text().toFloat();
+    float ySp = cappiConfig.firstChildElement("ygridsp").text().toFloat();
+    float zSp = cappiConfig.firstChildElement("zgridsp").text().toFloat();
+    float zLow = cappiConfig.firstChildElement("zmin").text().toFloat();
+
+    // Same extent as gridRadarData, with the extra grid point the gate
+    // checks allow on each side
+    float* rel = getCartesianPoint(radarData->getRadarLat(), radarData->getRadarLon(), vortexLat, vortexLon);
+    float xLow = nearbyintf(rel[0] - (xDim / 2) * xSp) - xSp;
+    float xHigh = nearbyintf(rel[0] + (xDim / 2) * xSp) + xSp;
+    float yLow = nearbyintf(rel[1] - (yDim / 2) * ySp) - ySp;
+    float yHigh = nearbyintf(rel[1] + (yDim / 2) * ySp) + ySp;
+    float top = zLow + zDim*zSp + zSp;
+    delete[] rel;
+
+    // How close the grid comes to the radar, which sits at the origin
+    float dx = std::max(std::max(xLow, -xHigh), 0.0f);
+    float dy = std::max(std::max(yLow, -yHigh), 0.0f);
+    float nearest = sqrt(dx*dx + dy*dy);
+
+    // The beam only gets higher with range and elevation, so once it is
+    // over the top at the nearest range it is over it everywhere in the grid
+    float low = 0;
+    float high = 90;
+    if (radarData->radarBeamHeight(nearest, high) <= top)
+        return 91;
+    for (int n = 0; n < 24; n++) {
+        float mid = 0.5 * (low + high);
+        if (radarData->radarBeamHeight(nearest, mid) > top)
+            high = mid;
+        else
+            low = mid;
+    }
+    return high;
+}
+
 void CappiGrid::CressmanInterpolation(RadarData *radarData)
 {
     // Cressman Interpolation
@@ -153,8 +208,14 @@ void CappiGrid::CressmanInterpolation(RadarData *radarData)
     }
 
     // Find good values
+    qint64 usedGates = 0;
+    qint64 skippedRays = 0;
     for (int n = 0; n < radarData->getNumRays(); n++) {
         Ray* currentRay = radarData->getRay(n);
+        if (currentRay->getElevation() >= maxElevation) {
+            skippedRays++;
+            continue;
+        }
         float theta = deg2rad * fmodf((450. - currentRay->getAzimuth()),360.);
         float phi = deg2rad * (90. - (currentRay->getElevation()));
 
@@ -176,6 +237,7 @@ void CappiGrid::CressmanInterpolation(RadarData *radarData)
                 if ((z < (zmin - kGridsp)) or z > (zmax + kGridsp)) { continue; }
 
                 // Looks like a good point, find its closest Cartesian index
+                usedGates++;
                 float i = (x - xmin)/iGridsp;
                 float j = (y - ymin)/jGridsp;
                 float k = (z - zmin)/kGridsp;
@@ -225,6 +287,7 @@ void CappiGrid::CressmanInterpolation(RadarData *radarData)
                 if ((z < (zmin - kGridsp)) or z > (zmax + kGridsp)) { continue; }
 
                 // Looks like a good point, find its closest Cartesian index
+                usedGates++;
                 float i = (x - xmin)/iGridsp;
                 float j = (y - ymin)/jGridsp;
                 float k = (z - zmin)/kGridsp;
@@ -262,6 +325,9 @@ void CappiGrid::CressmanInterpolation(RadarData *radarData)
         //delete currentRay;
     }
 
+    StageStats::count("gridded_gates", usedGates);
+    StageStats::count("rays_above_grid", skippedRays);
+
     //Message::toScreen("# of Reflectivity gates used in CAPPI = "+QString().setNum(r));
     //Message::toScreen("# of Velocity gates used in CAPPI = "+QString().setNum(v));
 
@@ -293,6 +359,7 @@ void CappiGrid::CressmanInterpolation(RadarData *radarData)
         // Find good values
         for (int n = 0; n < radarData->getNumRays(); n++) {
             Ray* currentRay = radarData->getRay(n);
+            if (currentRay->getElevation() >= maxElevation) { continue; }
             float theta = deg2rad * fmodf((450. - currentRay->getAzimuth()),360.);
             float phi = deg2rad * (90. - (currentRay->getElevation()));
 
@@ -535,6 +602,279 @@ void CappiGrid::CressmanInterpolation(RadarData *radarData)
 
 }
 
+void BarnesSliceTask::run()
+{
+    _grid->barnesSlice(_jStart, _jEnd, _pass);
+}
+
+void CappiGrid::BarnesInterpolation(RadarData *radarData, QDomElement cappiConfig)
+{
+    // Barnes Interpolation (see Koch et al, 1983 for details)
+
+    // The first pass uses the falloff for a data spacing of twice the grid
+    // spacing. Each further pass adds the weighted residuals at the gates
+    // with the falloff scaled by gamma.
+    int passes = 2;
+    QDomElement p = cappiConfig.firstChildElement("barnespasses");
+    if (! p.isNull())
+        passes = std::max(1, p.text().toInt());
+    barnesGamma = 0.3;
+    QDomElement g = cappiConfig.firstChildElement("barnesgamma");
+    if (! g.isNull())
+        barnesGamma = g.text().toFloat();
+
+    barnesFalloff[0] = 5.052*pow((4* iGridsp / Pi),2);
+    barnesFalloff[1] = 5.052*pow((4* jGridsp / Pi),2);
+    barnesFalloff[2] = 5.052*pow((4* kGridsp / Pi),2);
+
+    if ((int(iDim) < 1) or (int(jDim) < 1) or (int(kDim) < 1))
+        return;
+
+    addBarnesGates(radarData);
+    binBarnesObs(refObs);
+    binBarnesObs(velObs);
+
+    // Split the rows into a few bands per thread so uneven data density
+    // still balances out
+    QThreadPool pool;
+    pool.setMaxThreadCount(VolumeScheduler::threadBudget());
+    int bands = std::min(int(jDim), pool.maxThreadCount() * 4);
+    int rowsPerBand = (int(jDim) + bands - 1) / bands;
+    for (int pass = 0; pass < passes; pass++) {
+        if (pass > 0) {
+            updateBarnesResiduals(refObs, 0);
+            updateBarnesResiduals(velObs, 1);
+        }
+        for (int j = 0; j < int(jDim); j += rowsPerBand)
+            pool.start(new BarnesSliceTask(this, j, std::min(j + rowsPerBand, int(jDim)), pass));
+        pool.waitForDone();
+    }
+
+    refObs = BarnesObs();
+    velObs = BarnesObs();
+}
+
+void CappiGrid::addBarnesGates(RadarData *radarData)
+{
+    refObs = BarnesObs();
+    velObs = BarnesObs();
+
+    qint64 skippedRays = 0;
+    for (int n = 0; n < radarData->getNumRays(); n++) {
+        Ray* currentRay = radarData->getRay(n);
+        if (currentRay->getElevation() >= maxElevation) {
+            skippedRays++;
+            continue;
+        }
+        float theta = deg2rad * fmodf((450. - currentRay->getAzimuth()),360.);
+        float phi = deg2rad * (90. - (currentRay->getElevation()));
+
+        for (int field = 0; field < 2; field++) {
+            int numGates;
+            float firstGate, gateSp;
+            float* data;
+            BarnesObs* obs;
+            if (field == 0) {
+                if (! gridReflectivity) { continue; }
+                numGates = currentRay->getRef_numgates();
+                firstGate = currentRay->getFirst_ref_gate();
+                gateSp = currentRay->getRef_gatesp();
+                data = currentRay->getRefData();
+                obs = &refObs;
+            } else {
+                numGates = currentRay->getVel_numgates();
+                firstGate = currentRay->getFirst_vel_gate();
+                gateSp = currentRay->getVel_gatesp();
+                data = currentRay->getVelData();
+                obs = &velObs;
+            }
+            for (int g = 0; g < numGates; g++) {
+                if (data[g] == -999.) { continue; }
+                float range = float(firstGate + (g * gateSp))/1000.;
+
+                float x = range*sin(phi)*cos(theta);
+                if ((x < (xmin - iGridsp)) or x > (xmax + iGridsp)) { continue; }
+                float y = range*sin(phi)*sin(theta);
+                if ((y < (ymin - jGridsp)) or y > (ymax + jGridsp)) { continue; }
+                float z = radarData->radarBeamHeight(range,
+                                                     currentRay->getElevation() );
+                if ((z < (zmin - kGridsp)) or z > (zmax + kGridsp)) { continue; }
+
+                obs->x.push_back(x);
+                obs->y.push_back(y);
+                obs->z.push_back(z);
+                obs->value.push_back(data[g]);
+            }
+        }
+    }
+    StageStats::count("gridded_gates", qint64(refObs.value.size() + velObs.value.size()));
+    StageStats::count("rays_above_grid", skippedRays);
+}
+
+void CappiGrid::binBarnesObs(BarnesObs &obs)
+{
+    // Counting sort of the gates by their nearest grid point
+    int nI = int(iDim);
+    int nJ = int(jDim);
+    int nK = int(kDim);
+    size_t n = obs.value.size();
+    std::vector<int> bin(n);
+    obs.binStart.assign(nI*nJ*nK + 1, 0);
+    for (size_t m = 0; m < n; m++) {
+        int i = std::min(std::max((int)lrintf((obs.x[m] - xmin)/iGridsp), 0), nI-1);
+        int j = std::min(std::max((int)lrintf((obs.y[m] - ymin)/jGridsp), 0), nJ-1);
+        int k = std::min(std::max((int)lrintf((obs.z[m] - zmin)/kGridsp), 0), nK-1);
+        bin[m] = (i*nJ + j)*nK + k;
+        obs.binStart[bin[m] + 1]++;
+    }
+    for (int b = 0; b < nI*nJ*nK; b++)
+        obs.binStart[b + 1] += obs.binStart[b];
+
+    std::vector<int> next(obs.binStart.begin(), obs.binStart.end() - 1);
+    std::vector<float> x(n), y(n), z(n), value(n);
+    for (size_t m = 0; m < n; m++) {
+        int d = next[bin[m]]++;
+        x[d] = obs.x[m];
+        y[d] = obs.y[m];
+        z[d] = obs.z[m];
+        value[d] = obs.value[m];
+    }
+    obs.x.swap(x);
+    obs.y.swap(y);
+    obs.z.swap(z);
+    obs.value.swap(value);
+    obs.residual = obs.value;
+}
+
+void CappiGrid::barnesSlice(int jStart, int jEnd, int pass)
+{
+    float falloff_x = barnesFalloff[0];
+    float falloff_y = barnesFalloff[1];
+    float falloff_z = barnesFalloff[2];
+    if (pass > 0) {
+        falloff_x *= barnesGamma;
+        falloff_y *= barnesGamma;
+        falloff_z *= barnesGamma;
+    }
+
+    // Gates beyond this weight exponent do not change the analysis, so only
+    // the bins within that distance of a grid point are visited
+    const float maxExponent = 10.;
+    int nI = int(iDim);
+    int nJ = int(jDim);
+    int nK = int(kDim);
+    int iReach = (int)ceilf(sqrtf(maxExponent * falloff_x) / iGridsp);
+    int jReach = (int)ceilf(sqrtf(maxExponent * falloff_y) / jGridsp);
+    int kReach = (int)ceilf(sqrtf(maxExponent * falloff_z) / kGridsp);
+
+    for (int j = jStart; j < jEnd; j++) {
+        float yg = ymin + j*jGridsp;
+        for (int i = 0; i < nI; i++) {
+            float xg = xmin + i*iGridsp;
+            for (int k = 0; k < nK; k++) {
+                float zg = zmin + k*kGridsp;
+
+                float sumRef = 0;
+                float sumVel = 0;
+                float sumHt = 0;
+                float refWeight = 0;
+                float velWeight = 0;
+
+                for (int bi = std::max(0, i - iReach); bi <= std::min(nI-1, i + iReach); bi++) {
+                    for (int bj = std::max(0, j - jReach); bj <= std::min(nJ-1, j + jReach); bj++) {
+                        for (int bk = std::max(0, k - kReach); bk <= std::min(nK-1, k + kReach); bk++) {
+                            int b = (bi*nJ + bj)*nK + bk;
+                            for (int m = refObs.binStart[b]; m < refObs.binStart[b+1]; m++) {
+                                float dx = refObs.x[m] - xg;
+                                float dy = refObs.y[m] - yg;
+                                float dz = refObs.z[m] - zg;
+                                float e = (dx*dx)/falloff_x + (dy*dy)/falloff_y + (dz*dz)/falloff_z;
+                                if (e > maxExponent) { continue; }
+                                float weight = expf(-e);
+                                refWeight += weight;
+                                sumRef += weight*refObs.residual[m];
+                            }
+                            for (int m = velObs.binStart[b]; m < velObs.binStart[b+1]; m++) {
+                                float dx = velObs.x[m] - xg;
+                                float dy = velObs.y[m] - yg;
+                                float dz = velObs.z[m] - zg;
+                                float e = (dx*dx)/falloff_x + (dy*dy)/falloff_y + (dz*dz)/falloff_z;
+                                if (e > maxExponent) { continue; }
+                                float weight = expf(-e);
+                                velWeight += weight;
+                                sumVel += weight*velObs.residual[m];
+                                sumHt += weight*velObs.z[m];
+                            }
+                        }
+                    }
+                }
+
+                if (pass == 0) {
+                    dataGrid[0][i][j][k] = -999;
+                    dataGrid[1][i][j][k] = -999;
+                    dataGrid[2][i][j][k] = -999;
+                    if (refWeight > 0) {
+                        dataGrid[0][i][j][k] = sumRef/refWeight;
+                    }
+                    if (velWeight > 0) {
+                        dataGrid[1][i][j][k] = sumVel/velWeight;
+                        dataGrid[2][i][j][k] = sumHt/velWeight;
+                    }
+                } else {
+                    if ((refWeight > 0) and (dataGrid[0][i][j][k] != -999)) {
+                        dataGrid[0][i][j][k] += sumRef/refWeight;
+                    }
+                    if ((velWeight > 0) and (dataGrid[1][i][j][k] != -999)) {
+                        dataGrid[1][i][j][k] += sumVel/velWeight;
+                    }
+                }
+            }
+        }
+    }
+}
+
+float CappiGrid::barnesAnalysisAt(int field, float x, float y, float z)
+{
+    // Trilinear interpolation of the current analysis at a gate, using only
+    // the corners that have data
+    int dims[3] = { int(iDim), int(jDim), int(kDim) };
+    float pos[3] = { (x - xmin)/iGridsp, (y - ymin)/jGridsp, (z - zmin)/kGridsp };
+    int lo[3], hi[3];
+    float frac[3];
+    for (int d = 0; d < 3; d++) {
+        pos[d] = std::min(std::max(pos[d], 0.0f), float(dims[d] - 1));
+        lo[d] = (int)pos[d];
+        hi[d] = std::min(lo[d] + 1, dims[d] - 1);
+        frac[d] = pos[d] - lo[d];
+    }
+
+    float sum = 0;
+    float sumWeight = 0;
+    for (int corner = 0; corner < 8; corner++) {
+        int i = (corner & 1) ? hi[0] : lo[0];
+        int j = (corner & 2) ? hi[1] : lo[1];
+        int k = (corner & 4) ? hi[2] : lo[2];
+        float v = dataGrid[field][i][j][k];
+        if (v == -999) { continue; }
+        float weight = ((corner & 1) ? frac[0] : 1 - frac[0])
+            * ((corner & 2) ? frac[1] : 1 - frac[1])
+            * ((corner & 4) ? frac[2] : 1 - frac[2]);
+        sum += weight*v;
+        sumWeight += weight;
+    }
+    if (sumWeight > 0)
+        return sum/sumWeight;
+    return -999;
+}
+
+void CappiGrid::updateBarnesResiduals(BarnesObs &obs, int field)
+{
+    for (size_t m = 0; m < obs.value.size(); m++) {
+        float analysis = barnesAnalysisAt(field, obs.x[m], obs.y[m], obs.z[m]);
+        obs.residual[m] = (analysis == -999) ? 0 : obs.value[m] - analysis;
+    }
+}
+
 // TODO
 // I think all the NetCDF stuff should be kept in the NetCDF.cpp file.
 // Put it here for now. But I can see adding the ability to read different file formats
@@ -627,6 +967,7 @@ bool CappiGrid::getFillValue(Nc3Var *var, float &val)
 void CappiGrid::loadPreGridded(RadarData *radarData, QDomElement cappiConfig)
 {
   Nc3Error ncError(Nc3Error::verbose_nonfatal); // Prevent NertCDF error from exiting the program
+  StageTimer timer("gridding");
 
   // Fill in the grid from a NetCdf file containing pre-gridded data.
   QString fname = radarData->getFileName();
@@ -715,21 +1056,15 @@ void CappiGrid::loadPreGridded(RadarData *radarData, QDomElement cappiConfig)
   // latReference, lonReference, (from grid_mapping in .nc file and xml, warn if way different like full degree)
   // maxRRefIndex, maxVelIndex,  not used??
 
-  float *ref = (float *) malloc(sizeof(float)  * iDim * jDim);
-  float *vel = (float *) malloc(sizeof(float)  * iDim * jDim);
-  float *spec = (float *) malloc(sizeof(float) * iDim * jDim);
-
-  if (ref == NULL || vel == NULL || spec == NULL) {
-    std::cerr << "Error: CappiGrid::loadPreGriddedCouldn't allocate memory" << std::endl;
+  if (reflectivity == NULL || velocity == NULL || spectrum == NULL)
     return;
-  }
 
   // code uses -999 for invalid values.
   // find out fill values for the 3 variables
 
-  float ref_fill;
-  float vel_fill;
-  float spec_fill;
+  float ref_fill = -999;
+  float vel_fill = -999;
+  float spec_fill = -999;
 
   if (! getFillValue(reflectivity, ref_fill) ) 
     std::cerr << "Can't get reflectivity fill value from " << fname.toLatin1().data() << std::endl;
@@ -743,60 +1078,86 @@ void CappiGrid::loadPreGridded(RadarData *radarData, QDomElement cappiConfig)
   int yDim = (int) jDim;
   int zDim = (int) kDim;
 
-  for(int k = 0; k < zDim; k++) {
-    if (! reflectivity->set_cur(time, k, 0, 0, -1) ) {
-	std::cerr << "Couldn't set reflectivity corner" << std::endl;
-	break;
+  // The variables are stored (time, z0, y0, x0). Read them a band of y0 rows
+  // at a time with every level in one hyperslab, so each read is a single
+  // contiguous request in the file's own order and the band holds complete
+  // k columns for the grid.
+
+  std::vector<Nc3Var *> vars = { reflectivity, velocity, spectrum };
+  std::vector<float> fills = { ref_fill, vel_fill, spec_fill };
+  QStringList names = { "reflectivity", "velocity", "spectrum width" };
+  std::vector<FieldHandle> handles = { 0, 1, 2 };
+
+  // Further variables listed in <extrafields>, such as "ZDR RHOHV", are
+  // read into fields of their own
+  QDomElement e = cappiConfig.firstChildElement("extrafields");
+  QStringList extraNames;
+  if (! e.isNull())
+    extraNames = e.text().simplified().split(' ');
+  for (int n = 0; n < extraNames.size(); n++) {
+    if (extraNames[n].isEmpty())
+      continue;
+    Nc3Var *var = file.get_var(extraNames[n].toLatin1().data());
+    if (var == NULL) {
+      std::cerr << "Can't get " << extraNames[n].toLatin1().data() << " from "
+		<< fname.toLatin1().data() << std::endl;
+      continue;
+    }
+    float fill = -999;
+    if (! getFillValue(var, fill) )
+      std::cerr << "Can't get " << extraNames[n].toLatin1().data() << " fill value from "
+		<< fname.toLatin1().data() << std::endl;
+    vars.push_back(var);
+    fills.push_back(fill);
+    names << extraNames[n];
+    handles.push_back(addField(extraNames[n]));
+  }
+
+  const long chunkValues = 1 << 22;
+  int rowsPerChunk = std::max(1L, chunkValues / ((long) zDim * xDim));
+  rowsPerChunk = std::min(rowsPerChunk, yDim);
+  std::vector<float> chunk((size_t) zDim * rowsPerChunk * xDim);
+
+  for (int y0 = 0; y0 < yDim; y0 += rowsPerChunk) {
+    int rows = std::min(rowsPerChunk, yDim - y0);
+    for (size_t field = 0; field < vars.size(); field++) {
+      if (! vars[field]->set_cur(time, 0, y0, 0, -1) ) {
+	std::cerr << "Couldn't set " << names[field].toLatin1().data() << " corner" << std::endl;
+	return;
       }
-    if (! velocity->set_cur(time, k, 0, 0, -1) ) {
-	std::cerr << "Couldn't set velocity corner" << std::endl;
-	break;
+      if (! vars[field]->get(chunk.data(), 1, zDim, rows, xDim) ) {
+	std::cerr << "Couldn't get " << names[field].toLatin1().data() << " value" << std::endl;
+	return;
       }
-    if (! spectrum->set_cur(time, k, 0, 0, -1) ) {
-	std::cerr << "Couldn't set spectrum width corner" << std::endl;
-	break;
-    }
-    if (! reflectivity->get(ref, 1, 1, yDim, xDim) ) {
-      std::cerr << "Couldn't get reflectivity value" << std::endl;
-      break;
+      StageStats::count("bytes_read", qint64(sizeof(float)) * zDim * rows * xDim);
+      storePreGriddedRows(handles[field], chunk.data(), fills[field], y0, rows, xDim, zDim);
     }
-    if (! velocity->get(vel, 1, 1, yDim, xDim) ) {
-      std::cerr << "Couldn't get Velocity value" << std::endl;
-      break;
-    }
-    if (! spectrum->get(spec, 1, 1, yDim, xDim) ) {
-      std::cerr << "Couldn't get Spectrum Width value" << std::endl;
-      break;
-    }
-    //	std::cerr << "[" << i << ", " << j << ", " << k << "] " <<
-    //	  "ref: " << ref << ", vel: " << vel << std::endl;
-    float v;
-
-    // Looks like x and y are swapped in the NetCDF file.
-      
-    for(int i = 0; i < xDim; i++) {
-      for(int j = 0; j < yDim; j++) {
-	v = *(ref + i * yDim + j);		// reflectivity (REF)
-	if (v <= ref_fill)
-	  v = -999;
-	dataGrid[0][j][i][k] = v;	
-
-	v = *(vel + i * yDim + j);		// dopler velocity magnitude (VU)
-	if (v <= vel_fill)
-	  v = -999;
-	dataGrid[1][j][i][k] = v;
-
-	v = *(spec + i * yDim + j);		// spectral grid width (SW)
-	if (v <= spec_fill)
-	  v = -999;
-	dataGrid[2][j][i][k] = v;
+  }
+}
+
+void CappiGrid::storePreGriddedRows(FieldHandle field, const float *chunk, float fill,
+				    int yStart, int rows, int xDim, int zDim)
+{
+  // chunk is [k][row][x] as read from the file while dataGrid has k fastest.
+  // Walk x in short blocks so the destination columns stay in cache while
+  // each level of the band streams through once.
+
+  const int xBlock = 64;
+  for (int r = 0; r < rows; r++) {
+    int j = yStart + r;
+    for (int x0 = 0; x0 < xDim; x0 += xBlock) {
+      int x1 = std::min(x0 + xBlock, xDim);
+      for (int k = 0; k < zDim; k++) {
+	const float *src = chunk + ((size_t) k * rows + r) * xDim;
+	for (int i = x0; i < x1; i++) {
+	  float v = src[i];
+	  if (v <= fill)
+	    v = -999;
+	  column(field, i, j)[k] = v;
+	}
       }
     }
   }
-  
-  free(ref);
-  free(vel);
-  free(spec);
 }
 
 /*
@@ -924,154 +1285,6 @@ void CappiGrid::BilinearInterpolation(RadarData *radarData)
  }
 }
 
-void CappiGrid::BarnesInterpolation()
-{
-
-  // Barnes Interpolation (see Koch et al, 1983 for details)
-
-  // Barnes Interpolation does not seem to be working right now -LM
-
-  float falloff_x = 5.052*pow((4* iGridsp / Pi),2);
-  float falloff_y = 5.052*pow((4* jGridsp / Pi),2);
-  float falloff_z = 5.052*pow((4* kGridsp / Pi),2);
-  float smoother = 0.3;
-
-
-  for (int k = 0; k < int(kDim); k++) {
-    for (int j = 0; j < int(jDim); j++) {
-      for (int i = 0; i < int(iDim); i++) {
-
- dataGrid[0][i][j][k] = -999.;
- dataGrid[1][i][j][k] = -999.;
- dataGrid[2][i][j][k] = -999.;
-
- float sumRef = 0;
- float sumVel = 0;
- float sumSw = 0;
- float refWeight = 0;
- float velWeight = 0;
-
- if(gridReflectivity) {
-   for (int n = 0; n <= maxRefIndex; n++) {
-     float dx = refValues[n].x - (xmin + i*iGridsp);
-     if (fabs(dx) > sqrt(20 * falloff_x)) { continue; }
-
-     float dy = refValues[n].y - (ymin + j*jGridsp);
-     if (fabs(dy) > sqrt(20 * falloff_y)) { continue; }
-
-     float dz = refValues[n].z - (zmin + k*kGridsp);
-     if (fabs(dz) > sqrt(20 * falloff_z)) { continue; }
-
-     float weight = exp(-(dx*dx)/falloff_x
-          -(dy*dy)/falloff_y
-          -(dz*dz)/falloff_z);
-
-     refWeight += weight;
-     sumRef += weight*refValues[n].refValue;
-   }
- }
-
- for (int n = 0; n <= maxVelIndex; n++) {
-   float dx = velValues[n].x - (xmin + i*iGridsp);
-   if (fabs(dx) > sqrt(20 * falloff_x)) { continue; }
-
-   float dy = velValues[n].y - (ymin + j*jGridsp);
-   if (fabs(dy) > sqrt(20 * falloff_y)) { continue; }
-
-   float dz = velValues[n].z - (zmin + k*kGridsp);
-   if (fabs(dz) > sqrt(20 * falloff_z)) { continue; }
-
-   float weight = exp(-(dx*dx)/falloff_x
-        -(dy*dy)/falloff_y
-        -(dz*dz)/falloff_z);
-
-   velWeight += weight;
-   sumVel += weight*velValues[n].velValue;
-   sumSw += weight*velValues[n].swValue;
-
- }
-
- if (refWeight > 0) {
-   dataGrid[0][i][j][k] = sumRef/refWeight;
- }
- if (velWeight > 0) {
-   dataGrid[1][i][j][k] = sumVel/velWeight;
-   dataGrid[2][i][j][k] = sumSw/velWeight;
- }
-      }
-    }
-  }
-
-  for (int k = 0; k < int(kDim); k++) {
-    for (int j = 0; j < int(jDim); j++) {
-      for (int i = 0; i < int(iDim); i++) {
-
- float sumRef = 0;
- float sumVel = 0;
- float sumSw = 0;
- float refWeight = 0;
- float velWeight = 0;
-
- if(gridReflectivity) {
-   for (int n = 0; n <= maxRefIndex; n++) {
-
-     float dx = refValues[n].x - (xmin + i*iGridsp);
-     if (fabs(dx) > sqrt(20 * falloff_x)) { continue; }
-
-     float dy = refValues[n].y - (ymin + j*jGridsp);
-     if (fabs(dy) > sqrt(20 * falloff_y)) { continue; }
-
-     float dz = refValues[n].z - (zmin + k*kGridsp);
-     if (fabs(dz) > sqrt(20 * falloff_z)) { continue; }
-
-     float weight = exp(-(dx*dx)/(falloff_x*smoother)
-          -(dy*dy)/(falloff_y*smoother)
-          -(dz*dz)/(falloff_z*smoother));
-
-
-     refWeight += weight;
-     float interpRef = trilinear(dx,dy,dz,0);
-     sumRef += weight*(refValues[n].refValue - interpRef);
-   }
- }
- for (int n = 0; n <= maxVelIndex; n++) {
-   float dx = velValues[n].x - (xmin + i*iGridsp);
-   if (fabs(dx) > sqrt(20 * falloff_x)) { continue; }
-
-   float dy = velValues[n].y - (ymin + j*jGridsp);
-   if (fabs(dy) > sqrt(20 * falloff_y)) { continue; }
-
-   float dz = velValues[n].z - (zmin + k*kGridsp);
-   if (fabs(dz) > sqrt(20 * falloff_z)) { continue; }
-
-   float weight = exp(-(dx*dx)/falloff_x
-        -(dy*dy)/falloff_y
-        -(dz*dz)/falloff_z);
-
-
-   velWeight += weight;
-   float interpVel = trilinear(dx,dy,dz,1);
-   float interpSw = trilinear(dx,dy,dz,2);
-   sumVel += weight*(velValues[n].velValue - interpVel);
-   sumSw += weight*(velValues[n].swValue - interpSw);
-
- }
-
- if (refWeight > 0) {
-   dataGrid[0][i][j][k] += sumRef/refWeight;
- }
- if (velWeight > 0) {
-   dataGrid[1][i][j][k] += sumVel/velWeight;
-   dataGrid[2][i][j][k] += sumSw/velWeight;
- }
-      }
-    }
-  }
-  Message::toScreen("Leaving Barnes");
-}
-
-
-
 float CappiGrid::trilinear(const float &x, const float &y,
          const float &z, const int &param)
 {
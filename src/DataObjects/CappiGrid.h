@@ -13,18 +13,46 @@
 
 #include <QDomElement>
 #include <QFile>
+#include <QRunnable>
+#include <vector>
 
 #include <Ncxx/Nc3xFile.hh>
 #include "Radar/RadarData.h"
 #include "DataObjects/GriddedData.h"
 
+class CappiGrid;
+
+// Runs one Barnes pass over a band of grid rows. Each band writes only its
+// own cells, so bands of the same pass can run at once.
+class BarnesSliceTask : public QRunnable
+{
+ public:
+  BarnesSliceTask(CappiGrid* grid, int jStart, int jEnd, int pass)
+    : _grid(grid), _jStart(jStart), _jEnd(jEnd), _pass(pass) {}
+  void run();
+
+ private:
+  CappiGrid* _grid;
+  int _jStart;
+  int _jEnd;
+  int _pass;
+};
+
 class CappiGrid : public GriddedData
 {
+  friend class BarnesSliceTask;
+
 
 public:
     CappiGrid();
     ~CappiGrid();
     void  gridRadarData(RadarData *radarData, QDomElement cappiConfig,float *vortexLat, float *vortexLon);
+
+    // Elevation (deg) from which a sweep passes over the top of the grid,
+    // even where the grid comes closest to the radar. Those sweeps can't
+    // add a single gate to the cappi.
+    static float topElevation(RadarData *radarData, QDomElement cappiConfig,
+                              float *vortexLat, float *vortexLon);
     
     void  loadPreGridded(RadarData *radarData, QDomElement cappiConfig);
     bool  getGridMapping(Nc3File &file, float &radar_lat, float &radar_lon);
@@ -33,6 +61,7 @@ public:
     bool  getFillValue(Nc3Var *var, float &val);
 
     void  CressmanInterpolation(RadarData *radarData);
+    void  BarnesInterpolation(RadarData *radarData, QDomElement cappiConfig);
     float trilinear(const float &x, const float &y,const float &z, const int &param);
     void  writeAsi();
     bool  writeAsi(const QString& fileName);
@@ -40,9 +69,12 @@ public:
 private:
 
     void setDisplayIndex(QDomElement cappiConfig, float kSpacing);
+    void storePreGriddedRows(FieldHandle field, const float *chunk, float fill,
+			     int yStart, int rows, int xDim, int zDim);
     
     float latReference;
     float lonReference;
+    float maxElevation;
 
     QString outFileName;
     float* relDist;
@@ -59,6 +91,27 @@ private:
         float weight;
     };
 
+    // Gates used by the Barnes analysis, sorted by the grid cell they fall
+    // in. binStart[b] is the first gate of cell b = (i*jDim + j)*kDim + k.
+    class BarnesObs {
+    public:
+        std::vector<float> x, y, z;
+        std::vector<float> value;
+        std::vector<float> residual;
+        std::vector<int> binStart;
+    };
+
+    void  addBarnesGates(RadarData *radarData);
+    void  binBarnesObs(BarnesObs &obs);
+    void  barnesSlice(int jStart, int jEnd, int pass);
+    float barnesAnalysisAt(int field, float x, float y, float z);
+    void  updateBarnesResiduals(BarnesObs &obs, int field);
+
+    BarnesObs refObs;
+    BarnesObs velObs;
+    float barnesFalloff[3];
+    float barnesGamma;
+
     bool gridReflectivity;
     long maxRefIndex;
     long maxVelIndex;
@@ -15,7 +15,7 @@ Coefficient::Coefficient()
     level = -999;
     radius = -999;
     value = -999;
-    parameter = QString("NULL");
+    parameter = NullId;
 }
 
 Coefficient::Coefficient(float newLevel, float newRadius, float newValue,QString name)
@@ -23,10 +23,18 @@ Coefficient::Coefficient(float newLevel, float newRadius, float newValue,QString
     level = newLevel;
     radius = newRadius;
     value = newValue;
-    parameter = name;
+    parameter = parameterId(name);
 
 }
 
+Coefficient::Coefficient(float newLevel, float newRadius, float newValue, int id)
+{
+    level = newLevel;
+    radius = newRadius;
+    value = newValue;
+    parameter = id;
+}
+
 Coefficient::Coefficient(const Coefficient &other)
 {
     this->level = other.level;
@@ -58,14 +66,68 @@ void Coefficient::setValue(const float &newValue)
 
 void Coefficient::setParameter(const QString &newParameter)
 {
-    parameter = newParameter;
+    parameter = parameterId(newParameter);
+}
+
+int Coefficient::parameterId(const QString &name)
+{
+    // Names are of the form VTC0: component, trig function, wavenumber
+    if(name.length() < 4)
+        return NullId;
+
+    Component comp;
+    QString compName = name.left(2);
+    if(compName == "VT")
+        comp = VT;
+    else if(compName == "VR")
+        comp = VR;
+    else if(compName == "VM")
+        comp = VM;
+    else
+        return NullId;
+
+    Trig trig;
+    if(name.at(2) == QChar('C'))
+        trig = Cos;
+    else if(name.at(2) == QChar('S'))
+        trig = Sin;
+    else
+        return NullId;
+
+    bool ok;
+    int waveNum = name.mid(3).toInt(&ok);
+    if(!ok)
+        return NullId;
+
+    return makeId(comp, trig, waveNum);
+}
+
+QString Coefficient::parameterName(const int &id)
+{
+    QString name;
+    switch(id >> 8) {
+    case VT:
+        name = "VT";
+        break;
+    case VR:
+        name = "VR";
+        break;
+    case VM:
+        name = "VM";
+        break;
+    default:
+        return QString("NULL");
+    }
+    name += ((id >> 7) & 1) ? "S" : "C";
+    name += QString().setNum(id & 0x7f);
+    return name;
 }
 
 bool Coefficient::operator == (const Coefficient &other)
 {
     if(level == other.getLevel())
         if(radius == other.getRadius())
-            if(parameter == other.getParameter())
+            if(parameter == other.parameter)
                 if(value == other.getValue())
                     return true;
     return false;
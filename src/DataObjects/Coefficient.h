@@ -17,8 +17,30 @@ class Coefficient
 {
 
 public:
+    // A coefficient is identified by its wind component, the trig function
+    // and the wavenumber, e.g. VTC0 or VTS1. These are packed into a small
+    // integer id so the ring fits never build or compare strings, the
+    // names are only generated when the coefficients are written out.
+    enum Component { NoComponent = 0, VT = 1, VR = 2, VM = 3 };
+    enum Trig { Cos = 0, Sin = 1 };
+
+    static constexpr int makeId(Component comp, Trig trig, int waveNum)
+        { return (comp << 8) | (trig << 7) | (waveNum & 0x7f); }
+
+    // The ids that the analysis refers to by name, matching makeId()
+    enum { NullId = 0,
+           VTC0 = (VT << 8) | (Cos << 7) | 0,
+           VRC0 = (VR << 8) | (Cos << 7) | 0,
+           VMC0 = (VM << 8) | (Cos << 7) | 0,
+           VTC1 = (VT << 8) | (Cos << 7) | 1,
+           VTS1 = (VT << 8) | (Sin << 7) | 1 };
+
+    static int parameterId(const QString &name);
+    static QString parameterName(const int &id);
+
     Coefficient();
     Coefficient(float newLevel, float newRadius, float newValue, QString name);
+    Coefficient(float newLevel, float newRadius, float newValue, int id);
     Coefficient(const Coefficient &other);
 
     bool isValid() const;
@@ -32,7 +54,10 @@ public:
     float getValue() const { return value; }
     void setValue(const float &newValue);
 
-    QString getParameter() const { return parameter; }
+    int getParameterId() const { return parameter; }
+    void setParameterId(const int &newId) { parameter = newId; }
+
+    QString getParameter() const { return parameterName(parameter); }
     void setParameter(const QString &newParameter);
 
     bool operator == (const Coefficient &other);
@@ -44,7 +69,7 @@ private:
     float level;
     float radius;
     float value;
-    QString parameter;
+    int parameter;
 
 };
 
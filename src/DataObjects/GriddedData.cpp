@@ -16,6 +16,7 @@
 #include "GriddedData.h"
 #include "IO/Message.h"
 #include <cmath>
+#include <algorithm>
 
 GriddedData::GriddedData()
 {
@@ -346,16 +347,41 @@ int GriddedData::getIndexFromCartesianPointK (const float& cartK) const
     return index;
 }
 
-int GriddedData::getFieldIndex(const QString& fieldName) const
+GriddedData::FieldHandle GriddedData::getFieldHandle(const QString& fieldName) const
 {
-    int field = -1;
     if((fieldName == "dz")||(fieldName == "DZ"))
-        field = 0;
+        return 0;
     if((fieldName == "ve") || (fieldName == "VE") || (fieldName == "VU") ) // TODO: VU?
-        field = 1;
+        return 1;
     if((fieldName == "ht")||(fieldName == "HT"))
-        field = 2;
-    if(field == -1)
+        return 2;
+    int extra = extraFieldNames.indexOf(fieldName.toUpper());
+    if(extra >= 0)
+        return maxFields + extra;
+    return noField;
+}
+
+GriddedData::FieldHandle GriddedData::addField(const QString& fieldName)
+{
+    // Adds a field at the current grid size, filled with -999, or clears
+    // it if it is already there
+    FieldHandle field = getFieldHandle(fieldName);
+    if(field == noField) {
+        extraFieldNames << fieldName.toUpper();
+        extraFields.resize(extraFieldNames.size());
+        field = maxFields + extraFieldNames.size() - 1;
+    }
+    if(field >= maxFields) {
+        QVector<float>& values = extraFields[field - maxFields];
+        values.fill(-999., (int)iDim*(int)jDim*(int)kDim);
+    }
+    return field;
+}
+
+int GriddedData::getFieldIndex(const QString& fieldName) const
+{
+    FieldHandle field = getFieldHandle(fieldName);
+    if(field == noField)
         Message::toScreen("GriddedData::GetFieldIndex: Failed to Select From Available Fields");
     return field;
 }
@@ -370,8 +396,38 @@ float GriddedData::getIndexValue(QString& fieldName, float& ii, float& jj, float
     if((ii > iDim)||(ii < 0)||(jj > jDim)||(jj < 0)||(kk > kDim)||(kk < 0))
         return -999.;
     int field = getFieldIndex(fieldName);
-    return dataGrid[field][(int)ii][(int)jj][(int)kk];
+    return column(field, (int)ii, (int)jj)[(int)kk];
+
+}
+
+float GriddedData::getIndexValue(FieldHandle field, int i, int j, int k) const
+{
+    if((field == noField)||(i >= iDim)||(i < 0)||(j >= jDim)||(j < 0)||(k >= kDim)||(k < 0))
+        return -999.;
+    return column(field, i, j)[k];
+}
+
+void GriddedData::getIndexSlice(const QString& fieldName, int k, float* slice) const
+{
+    getIndexSlice(getFieldIndex(fieldName), k, slice);
+}
 
+void GriddedData::getIndexSlice(FieldHandle field, int k, float* slice) const
+{
+    // Copies level k of a field into slice, row j at slice + j*iDim, for
+    // callers that walk a whole level. Missing levels come back as -999.
+
+    int nx = (int)iDim;
+    int ny = (int)jDim;
+    if((field == noField)||(k >= kDim)||(k < 0)) {
+        std::fill(slice, slice + nx*ny, -999.f);
+        return;
+    }
+    for(int i = 0; i < nx; i++) {
+        for(int j = 0; j < ny; j++) {
+            slice[j*nx + i] = column(field, i, j)[k];
+        }
+    }
 }
 
 float* GriddedData::getCartesianXslice(const QString& fieldName, 
@@ -401,10 +457,10 @@ float* GriddedData::getCartesianXslice(const QString& fieldName,
 
     for(int i = 0; i < iDim; i++) {
         float ave = 0;
-        ave += (1-jjMaxDiff)*(1-kkMinDiff)*dataGrid[field][i][jjMax][kkMin];
-        ave += (1-jjMinDiff)*(1-kkMinDiff)*dataGrid[field][i][jjMin][kkMin];
-        ave += (1-jjMaxDiff)*(1-kkMaxDiff)*dataGrid[field][i][jjMax][kkMax];
-        ave += (1-jjMinDiff)*(1-kkMaxDiff)*dataGrid[field][i][jjMin][kkMax];
+        ave += (1-jjMaxDiff)*(1-kkMinDiff)*column(field, i, jjMax)[kkMin];
+        ave += (1-jjMinDiff)*(1-kkMinDiff)*column(field, i, jjMin)[kkMin];
+        ave += (1-jjMaxDiff)*(1-kkMaxDiff)*column(field, i, jjMax)[kkMax];
+        ave += (1-jjMinDiff)*(1-kkMaxDiff)*column(field, i, jjMin)[kkMax];
         values[i] = ave;
     }
     return values;
@@ -438,10 +494,10 @@ float* GriddedData::getCartesianYslice(const QString& fieldName,
 
     for(int j = 0; j < jDim; j++) {
         float ave = 0;
-        ave += (1-iiMinDiff)*(1-kkMaxDiff)*dataGrid[field][iiMin][j][kkMax];
-        ave += (1-iiMaxDiff)*(1-kkMaxDiff)*dataGrid[field][iiMax][j][kkMax];
-        ave += (1-iiMinDiff)*(1-kkMinDiff)*dataGrid[field][iiMin][j][kkMin];
-        ave += (1-iiMaxDiff)*(1-kkMinDiff)*dataGrid[field][iiMax][j][kkMin];
+        ave += (1-iiMinDiff)*(1-kkMaxDiff)*column(field, iiMin, j)[kkMax];
+        ave += (1-iiMaxDiff)*(1-kkMaxDiff)*column(field, iiMax, j)[kkMax];
+        ave += (1-iiMinDiff)*(1-kkMinDiff)*column(field, iiMin, j)[kkMin];
+        ave += (1-iiMaxDiff)*(1-kkMinDiff)*column(field, iiMax, j)[kkMin];
         values[j] = ave;
     }
     return values;
@@ -474,10 +530,10 @@ float* GriddedData::getCartesianZslice(const QString& fieldName,
 
     for(int k = 0; k < kDim; k++) {
         float ave = 0;
-        ave += (1-jjMinDiff)*(1-iiMaxDiff)*dataGrid[field][iiMax][jjMin][k];
-        ave += (1-jjMaxDiff)*(1-iiMaxDiff)*dataGrid[field][iiMax][jjMax][k];
-        ave += (1-jjMinDiff)*(1-iiMinDiff)*dataGrid[field][iiMin][jjMin][k];
-        ave += (1-jjMaxDiff)*(1-iiMinDiff)*dataGrid[field][iiMin][jjMax][k];
+        ave += (1-jjMinDiff)*(1-iiMaxDiff)*column(field, iiMax, jjMin)[k];
+        ave += (1-jjMaxDiff)*(1-iiMaxDiff)*column(field, iiMax, jjMax)[k];
+        ave += (1-jjMinDiff)*(1-iiMinDiff)*column(field, iiMin, jjMin)[k];
+        ave += (1-jjMaxDiff)*(1-iiMinDiff)*column(field, iiMin, jjMax)[k];
         values[k] = ave;
     }
     return values;
@@ -486,6 +542,12 @@ float* GriddedData::getCartesianZslice(const QString& fieldName,
 float GriddedData::getCartesianValue(const QString& fieldName, const float& x, 
                                      const float& y, const float& z)
 {
+    return getCartesianValue(getFieldIndex(fieldName), x, y, z);
+}
+
+float GriddedData::getCartesianValue(FieldHandle field, const float& x,
+                                     const float& y, const float& z) const
+{
 
     /*
    * This returns the field value associated with the fieldName that
@@ -494,7 +556,8 @@ float GriddedData::getCartesianValue(const QString& fieldName, const float& x,
    *
    */
 
-    int field = getFieldIndex(fieldName);
+    if (field == noField)
+        return -999.;
 
     float jjIndex = getIndexFromCartesianPointJ(y);
     float iiIndex = getIndexFromCartesianPointI(x);
@@ -513,14 +576,14 @@ float GriddedData::getCartesianValue(const QString& fieldName, const float& x,
     float iiMaxDiff = iiMax - iiIndex;
 
     float ave = 0;
-    ave += (1-jjMinDiff)*(1-iiMaxDiff)*(1-kkMinDiff)*dataGrid[field][iiMax][jjMin][kkMin];
-    ave += (1-jjMaxDiff)*(1-iiMaxDiff)*(1-kkMinDiff)*dataGrid[field][iiMax][jjMax][kkMin];
-    ave += (1-jjMinDiff)*(1-iiMinDiff)*(1-kkMinDiff)*dataGrid[field][iiMin][jjMin][kkMin];
-    ave += (1-jjMaxDiff)*(1-iiMinDiff)*(1-kkMinDiff)*dataGrid[field][iiMin][jjMax][kkMin];
-    ave += (1-jjMinDiff)*(1-iiMaxDiff)*(1-kkMaxDiff)*dataGrid[field][iiMax][jjMin][kkMax];
-    ave += (1-jjMaxDiff)*(1-iiMaxDiff)*(1-kkMaxDiff)*dataGrid[field][iiMax][jjMax][kkMax];
-    ave += (1-jjMinDiff)*(1-iiMinDiff)*(1-kkMaxDiff)*dataGrid[field][iiMin][jjMin][kkMax];
-    ave += (1-jjMaxDiff)*(1-iiMinDiff)*(1-kkMaxDiff)*dataGrid[field][iiMin][jjMax][kkMax];
+    ave += (1-jjMinDiff)*(1-iiMaxDiff)*(1-kkMinDiff)*column(field, iiMax, jjMin)[kkMin];
+    ave += (1-jjMaxDiff)*(1-iiMaxDiff)*(1-kkMinDiff)*column(field, iiMax, jjMax)[kkMin];
+    ave += (1-jjMinDiff)*(1-iiMinDiff)*(1-kkMinDiff)*column(field, iiMin, jjMin)[kkMin];
+    ave += (1-jjMaxDiff)*(1-iiMinDiff)*(1-kkMinDiff)*column(field, iiMin, jjMax)[kkMin];
+    ave += (1-jjMinDiff)*(1-iiMaxDiff)*(1-kkMaxDiff)*column(field, iiMax, jjMin)[kkMax];
+    ave += (1-jjMaxDiff)*(1-iiMaxDiff)*(1-kkMaxDiff)*column(field, iiMax, jjMax)[kkMax];
+    ave += (1-jjMinDiff)*(1-iiMinDiff)*(1-kkMaxDiff)*column(field, iiMin, jjMin)[kkMax];
+    ave += (1-jjMaxDiff)*(1-iiMinDiff)*(1-kkMaxDiff)*column(field, iiMin, jjMax)[kkMax];
     return ave;
 
 }
@@ -575,7 +638,7 @@ float* GriddedData::getSphericalRangeData(QString& fieldName, float azimuth,
                         && (pAzimuth > (azimuth-sphericalAzimuthSpacing/2.))) {
                     if((pElevation <=(elevation+sphericalElevationSpacing/2.))
                             && (pElevation > (elevation-sphericalElevationSpacing/2.))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                     }
                 }
@@ -659,7 +722,7 @@ float* GriddedData::getSphericalAzimuthData(QString& fieldName,
                         && (r > (range-sphericalRangeSpacing/2.))) {
                     if((pElevation <=(elevation+sphericalElevationSpacing/2.))
                             && (pElevation > (elevation-sphericalElevationSpacing/2.))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                     }
                 }
@@ -736,7 +799,7 @@ float* GriddedData::getSphericalElevationData(QString& fieldName, float range,
                         && (pAzimuth > (azimuth-sphericalAzimuthSpacing/2.))) {
                     if((r <= (range+sphericalRangeSpacing/2.))
                             && (r > (range-sphericalRangeSpacing/2.))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                     }
                 }
@@ -810,7 +873,7 @@ float* GriddedData::getCylindricalRadiusData(QString& fieldName, float azimuth,
                         && (pAzimuth > (azimuth-cylindricalAzimuthSpacing/2.))) {
                     if((k*kGridsp <= ((height/kGridsp)-zmin+cylindricalHeightSpacing/2.))
                             && (k*kGridsp > ((height/kGridsp)-zmin-cylindricalHeightSpacing/2.))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                     }
                 }
@@ -1029,7 +1092,7 @@ void GriddedData::getCylindricalAzimuthData(QString& fieldName, int numPoints,
     && (r > (radius-cylindricalRadiusSpacing/2.))) {
    if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
       && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
-     values[count] = dataGrid[field][i][j][k];
+     values[count] = column(field, i, j)[k];
      count++;
      if(count > numPoints) {
        // Memory overflow ... bail out
@@ -1078,7 +1141,7 @@ void GriddedData::getCylindricalAzimuthData(QString& fieldName,
                         && (r > (radius-cylindricalRadiusSpacing/2.))) {
                     if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
                             && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
 			// TODO debug
 			// std::cout << "val[" << count << "] = " << values[count] << std::endl;
                         count++;
@@ -1155,7 +1218,7 @@ void GriddedData::getCylindricalAzimuthDataTest2(QString& fieldName,
                         && (r > (radius-cylindricalRadiusSpacing/2.))) {
                     if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
                             && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                         if(count > numPoints) {
                             // Memory overflow ... bail out
@@ -1174,7 +1237,7 @@ void GriddedData::getCylindricalAzimuthDataTest2(QString& fieldName,
                         && (r > (radius-cylindricalRadiusSpacing/2.))) {
                     if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
                             && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                         if(count > numPoints) {
                             // Memory overflow ... bail out
@@ -1191,7 +1254,7 @@ void GriddedData::getCylindricalAzimuthDataTest2(QString& fieldName,
                         && (r > (radius-cylindricalRadiusSpacing/2.))) {
                     if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
                             && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                         if(count > numPoints) {
                             // Memory overflow ... bail out
@@ -1210,7 +1273,7 @@ void GriddedData::getCylindricalAzimuthDataTest2(QString& fieldName,
                         && (r > (radius-cylindricalRadiusSpacing/2.))) {
                     if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
                             && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                         if(count > numPoints) {
                             // Memory overflow ... bail out
@@ -1307,6 +1370,71 @@ void GriddedData::getCylindricalAzimuthPosition(int numPoints, float radius, flo
     }
 }
 
+void GriddedData::getCylindricalAzimuthRing(float radius, float height, CylindricalRing& ring)
+{
+    // Same search box and membership test as getCylindricalAzimuthData,
+    // but stored as offsets so they can be applied to any reference point
+    ring.radius = radius;
+    ring.height = height;
+    ring.di.clear();
+    ring.dj.clear();
+    ring.k.clear();
+    ring.azimuth.clear();
+
+    int iReach = int((radius+cylindricalRadiusSpacing)/iGridsp) + 2;
+    int jReach = int((radius+cylindricalRadiusSpacing)/jGridsp) + 2;
+    for(int di = -iReach; di < iReach; di++) {
+        for(int dj = -jReach; dj < jReach; dj++) {
+            float r = sqrt(iGridsp*iGridsp*di*di + jGridsp*jGridsp*dj*dj);
+            if((r > (radius+cylindricalRadiusSpacing/2.))
+                    || (r <= (radius-cylindricalRadiusSpacing/2.)))
+                continue;
+            float azimuth = fixAngle(atan2(float(dj), float(di)))*rad2deg;
+            for(int k = 0; k < kDim; k++) {
+                if((k <= (((height-zmin)/kGridsp)+cylindricalHeightSpacing/2))
+                        && (k > (((height-zmin)/kGridsp)-cylindricalHeightSpacing/2))) {
+                    ring.di.append(di);
+                    ring.dj.append(dj);
+                    ring.k.append(k);
+                    ring.azimuth.append(azimuth);
+                }
+            }
+        }
+    }
+}
+
+int GriddedData::getCylindricalAzimuthData(const QString& fieldName, const CylindricalRing& ring,
+                                           float x, float y, float* values, float* positions) const
+{
+    return getCylindricalAzimuthData(getFieldIndex(fieldName), ring, x, y, values, positions);
+}
+
+int GriddedData::getCylindricalAzimuthData(FieldHandle field, const CylindricalRing& ring,
+                                           float x, float y, float* values, float* positions) const
+{
+    // values and positions must hold at least ring.k.size() points,
+    // returns the number of points that fall inside the grid
+    if(field == noField)
+        return 0;
+
+    // Snap the center to the grid as setCartesianReferencePoint does
+    int refI = int(floor((x - xmin)/iGridsp+.5));
+    int refJ = int(floor((y - ymin)/jGridsp+.5));
+
+    int count = 0;
+    int numPoints = ring.k.size();
+    for(int n = 0; n < numPoints; n++) {
+        int i = refI + ring.di[n];
+        int j = refJ + ring.dj[n];
+        if((i < 0) || (i >= iDim) || (j < 0) || (j >= jDim))
+            continue;
+        values[count] = column(field, i, j)[ring.k[n]];
+        positions[count] = ring.azimuth[n];
+        count++;
+    }
+    return count;
+}
+
 void GriddedData::getCylindricalAzimuthPositionTest2(int numPoints, float radius, float height, float* positions) 
 {
     //  int numPoints = getCylindricalAzimuthLength(radius, height);
@@ -1485,7 +1613,7 @@ float* GriddedData::getCylindricalHeightData(QString& fieldName, float radius,
                 if((pAzimuth <= azimuth+cylindricalAzimuthSpacing/2.)
                         && (pAzimuth > azimuth-cylindricalAzimuthSpacing/2.)) {
                     for(int k = 0; k < kDim; k++){
-                        data[count] = dataGrid[field][i][j][k];
+                        data[count] = column(field, i, j)[k];
                         count++;
                     }
                 }
@@ -1737,7 +1865,7 @@ float* GriddedData::getSphericalRangeDataTest(QString& fieldName,
                         && (pAzimuth > (azimuth-sphericalAzimuthSpacing/2.))) {
                     if((pElevation <=(elevation+sphericalElevationSpacing/2.))
                             && (pElevation > (elevation-sphericalElevationSpacing/2.))) {
-                        values[count] = dataGrid[field][i][j][k];
+                        values[count] = column(field, i, j)[k];
                         count++;
                     }
                 }
@@ -15,6 +15,22 @@
 #include "IO/Message.h"
 #include <QDomElement>
 #include <QStringList>
+#include <QVector>
+
+/*
+ * Grid offsets (relative to the reference point) and azimuths of the points
+ * that make up one cylindrical ring. Membership only depends on the radius
+ * and height, so one table can be shared by every candidate center.
+ */
+struct CylindricalRing
+{
+  float radius;
+  float height;
+  QVector<int> di;
+  QVector<int> dj;
+  QVector<int> k;
+  QVector<float> azimuth;
+};
 
 class GriddedData 
 {
@@ -82,10 +98,27 @@ class GriddedData
   float* getCylindricalPositions();
   float* getSphericalPositions();
 
+  /* Fields are addressed by handle. Resolve the name once with
+     getFieldHandle and pass the handle in loops; the QString accessors
+     resolve it on every call. DZ, VE and HT are always present, further
+     fields (ZDR, RHOHV, ...) are added with addField at the current grid
+     size. */
+  typedef int FieldHandle;
+  static const FieldHandle noField = -1;
+  FieldHandle getFieldHandle(const QString& fieldName) const;
+  FieldHandle addField(const QString& fieldName);
+  int   getNumFields() const { return maxFields + extraFieldNames.size(); }
+  // The kDim values of a field at (i, j), k varying fastest
+  const float* getColumn(FieldHandle field, int i, int j) const { return column(field, i, j); }
+
   /* these are all done in Math Coordinates, should we changes the names,
      so the sound less like meteorological coords?  -LM */
   int   getFieldIndex(const QString& fieldName) const;
   float getIndexValue(QString& fieldName, float& i, float& j, float& k) const;
+  float getIndexValue(FieldHandle field, int i, int j, int k) const;
+  // One level of a field as iDim*jDim values, i varying fastest
+  void getIndexSlice(const QString& fieldName, int k, float* slice) const;
+  void getIndexSlice(FieldHandle field, int k, float* slice) const;
 
   /* Needed a reference point before we could redo coordinate systems. -LM */
   // Cartesian Coordinates
@@ -93,6 +126,7 @@ class GriddedData
   float* getCartesianYslice(const QString& fieldName, const float& x, const float& z);
   float* getCartesianZslice(const QString& fieldName, const float& x, const float& y);
   float  getCartesianValue(const QString& fieldName, const float& x,const float& y, const float& z);
+  float  getCartesianValue(FieldHandle field, const float& x,const float& y, const float& z) const;
  
   // Spherical Coordinates
   int    getSphericalRangeLength(float azimuth, float elevation);
@@ -122,6 +156,12 @@ class GriddedData
   int    getCylindricalAzimuthLength(float radius, float height);
   void   getCylindricalAzimuthData(QString& fieldName,int numPoints, float radius, float height, float* values);
   void   getCylindricalAzimuthPosition(int numPoints, float radius, float height, float* positions);
+  // Ring table and extraction around an explicit center (km), leaves the reference point alone
+  void   getCylindricalAzimuthRing(float radius, float height, CylindricalRing& ring);
+  int    getCylindricalAzimuthData(const QString& fieldName, const CylindricalRing& ring,
+                                   float x, float y, float* values, float* positions) const;
+  int    getCylindricalAzimuthData(FieldHandle field, const CylindricalRing& ring,
+                                   float x, float y, float* values, float* positions) const;
   int    getCylindricalHeightLength(float radius, float height);
   float* getCylindricalHeightData(QString& fieldName, float radius,float height);
   float* getCylindricalHeightPosition(float radius, float height);
@@ -171,6 +211,21 @@ class GriddedData
   //dataGrid[1] = doppler velocity magnitude
   //dataGrid[2] = spectral width
 
+  // Fields beyond maxFields, each iDim*jDim*kDim with k fastest
+  QStringList extraFieldNames;
+  QVector<QVector<float> > extraFields;
+
+  const float* column(FieldHandle field, int i, int j) const {
+    if (field < maxFields)
+      return dataGrid[field][i][j];
+    return extraFields[field - maxFields].constData() + (i*(int)jDim + j)*(int)kDim;
+  }
+  float* column(FieldHandle field, int i, int j) {
+    if (field < maxFields)
+      return dataGrid[field][i][j];
+    return extraFields[field - maxFields].data() + (i*(int)jDim + j)*(int)kDim;
+  }
+
   float sphericalRangeSpacing;
   float sphericalAzimuthSpacing;
   float sphericalElevationSpacing;
@@ -21,25 +21,9 @@ SimplexData::SimplexData()
     numRadii = MAXRADII;
     numCenters = MAXCENTERS;
     numPointsUsed = 0;
+    numPointsRefined = 0;
 
-    for(int i = 0; i < numLevels; i++)
-    {
-        //height[i] = velNull;
-        for(int j = 0; j < numRadii; j++) {
-            meanX[i][j] = _fillv;
-            meanY[i][j] = _fillv;
-            centerStdDeviation[i][j] = _fillv;
-            meanVT[i][j] = _fillv;
-            meanVTUncertainty[i][j] = _fillv;
-            numConvergingCenters[i][j] = (int)_fillv;
-            radius[j] = _fillv;
-            for(int k = 0; k < numCenters; k++) {
-                centers[i][j][k] = Center();
-                initialX[i][j][k] = _fillv;
-                initialY[i][j][k] = _fillv;
-            }
-        }
-    }
+    allocate();
 
     time = QDateTime();
 
@@ -47,80 +31,50 @@ SimplexData::SimplexData()
 
 SimplexData::SimplexData(int availLevels, int availRadii, int availCenters)
 {
-  numLevels = availLevels;        // TODO numLevels could be larger than MAXLEVELS
+  numLevels = availLevels;
   numRadii = availRadii;
   numCenters = availCenters;
   numPointsUsed = 0;
+  numPointsRefined = 0;
 
-  for(int i = 0; i < numLevels; i++)
-    {
-      height[i] = _fillv;
-      for(int j = 0; j < numRadii; j++)
-        {
-	  meanX[i][j] = _fillv;
-	  meanY[i][j] = _fillv;
-	  centerStdDeviation[i][j] = _fillv;
-	  meanVT[i][j] = _fillv;
-	  meanVTUncertainty[i][j] = _fillv;
-	  numConvergingCenters[i][j]= int(_fillv);
-	  radius[j] = _fillv;
-	  for(int k = 0; k < numCenters; k++) {
-	    centers[i][j][k] = Center();
-	    initialX[i][j][k] = _fillv;
-	    initialY[i][j][k] = _fillv;
-	  }
-        }
-    }
+  allocate();
 
   time = QDateTime();
 }
 
-// SimplexData::SimplexData(const SimplexData& other)
-// {
-//     this->numLevels = other.numLevels;
-//     this->numRadii = other.numRadii;
-//     this->numCenters = other.numCenters;
-//     this->numPointsUsed = other.numPointsUsed;
-
-//     for(int i = 0; i < this->numLevels; i++)
-//     {
-//         this->height[i] = other.height[i];
-//         for(int j = 0; j < this->numRadii; j++)
-//         {
-//             this->meanX[i][j] = other.meanX[i][j];
-//             this->meanY[i][j] = other.meanY[i][j];
-//             this->centerStdDeviation[i][j] = other.centerStdDeviation[i][j];
-//             this->meanVT[i][j] = other.meanVT[i][j];
-//             this->meanVTUncertainty[i][j] = other.meanVTUncertainty[i][j];
-//             this->numConvergingCenters[i][j]= other.numConvergingCenters[i][j];
-//             this->radius[j] = other.radius[j];
-//             for(int k = 0; k < this->numCenters; k++) {
-//                 this->centers[i][j][k] = other.centers[i][j][k];
-//                 initialX[i][j][k] = other.initialX[i][j][k];
-//                 initialY[i][j][k] = other.initialY[i][j][k];
-//             }
-//         }
-//     }
-
-//     this->time = other.time;
-// }
-
-SimplexData::~SimplexData()
+void SimplexData::allocate()
 {
+    // Size every array to the current dimensions and fill it
+    int numLevRad = numLevels * numRadii;
+    int numLevRadCen = numLevRad * numCenters;
+
+    height.assign(numLevels, _fillv);
+    radius.assign(numRadii, _fillv);
+
+    meanX.assign(numLevRad, _fillv);
+    meanY.assign(numLevRad, _fillv);
+    centerStdDeviation.assign(numLevRad, _fillv);
+    meanVT.assign(numLevRad, _fillv);
+    meanVTUncertainty.assign(numLevRad, _fillv);
+    numConvergingCenters.assign(numLevRad, int(_fillv));
+
+    centers.assign(numLevRadCen, Center());
+    initialX.assign(numLevRadCen, _fillv);
+    initialY.assign(numLevRadCen, _fillv);
 }
 
 float SimplexData::getMeanX(const int& lev, const int& rad) const
 {
     if ((lev < numLevels)&&(rad<numRadii))
-        return meanX[lev][rad];
+        return meanX[idx(lev, rad)];
     Message::toScreen("SimplexData: getX: Outside Bounds");
-    return meanX[0][0];
+    return _fillv;
 }
 
 void SimplexData::setMeanX(const int& lev, const int& rad, const float& newX)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanX[lev][rad] = newX;
+        meanX[idx(lev, rad)] = newX;
     else
         Message::toScreen("SimplexData: setX: Outside Bounds");
 }
@@ -129,22 +83,22 @@ void SimplexData::setMeanX(const float** a, const int& numLev, const int& numRad
 {
     for (int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            meanX[i][j] = a[i][j];
+            meanX[idx(i, j)] = a[i][j];
 }
 
 float SimplexData::getMeanY(const int& lev, const int& rad) const
 {
     if ((lev < numLevels) && (rad < numRadii))
-        return meanY[lev][rad];
+        return meanY[idx(lev, rad)];
     Message::toScreen("SimplexData: getY: Outside Bounds: Level = "+QString().setNum(lev) +
 		      " Radius = " + QString().setNum(rad));
-    return meanY[0][0];
+    return _fillv;
 }
 
 void SimplexData::setMeanY(const int& lev, const int& rad, const float& newY)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanY[lev][rad] = newY;
+        meanY[idx(lev, rad)] = newY;
     else
         Message::toScreen("SimplexData: setX: Outside Bounds");
 }
@@ -153,22 +107,22 @@ void SimplexData::setMeanY(const float** a, const int& numLev, const int& numRad
 {
     for (int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            meanY[i][j] = a[i][j];
+            meanY[idx(i, j)] = a[i][j];
 }
 
 float SimplexData::getCenterStdDev(const int& lev, const int& rad) const
 {
     if((lev < numLevels)&&(rad < numRadii))
-        return centerStdDeviation[lev][rad];
+        return centerStdDeviation[idx(lev, rad)];
     Message::toScreen("SimplexData: getCenterStdDev: Outside Bounds");
-    return centerStdDeviation[0][0];
+    return _fillv;
 }
 
 void SimplexData::setCenterStdDev(const int& lev, const int& rad,
                                   const float& number)
 {
     if((lev < numLevels)&&(rad < numRadii))
-        centerStdDeviation[lev][rad] = number;
+        centerStdDeviation[idx(lev, rad)] = number;
     else
         Message::toScreen("SimplexData: setCenterStdDev: Outside Bounds");
 }
@@ -178,7 +132,7 @@ void SimplexData::setCenterStdDev(const float** a, const int& numLev,
 {
     for(int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            centerStdDeviation[i][j]=a[i][j];
+            centerStdDeviation[idx(i, j)]=a[i][j];
 }
 
 float SimplexData::getHeight(const int& i) const
@@ -186,7 +140,7 @@ float SimplexData::getHeight(const int& i) const
     if (i < numLevels)
         return height[i];
     Message::toScreen("SimplexData: getHeight: Outside Bounds");
-    return height[0];
+    return _fillv;
 }
 
 
@@ -209,7 +163,7 @@ float SimplexData::getRadius(const int& i) const
     if (i < numRadii)
         return radius[i];
     Message::toScreen("SimplexData: getRadius: Outside Bounds");
-    return radius[0];
+    return _fillv;
 }
 
 
@@ -240,15 +194,15 @@ void SimplexData::setTime(const QDateTime& radarTime)
 float SimplexData::getMaxVT(const int& lev, const int& rad) const
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        return meanVT[lev][rad];
+        return meanVT[idx(lev, rad)];
     Message::toScreen("SimplexData: getMaxVT: Outside Bounds");
-    return meanVT[0][0];
+    return _fillv;
 }
 
 void SimplexData::setMaxVT(const int& lev, const int& rad, const float& vel)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanVT[lev][rad] = vel;
+        meanVT[idx(lev, rad)] = vel;
     else
         Message::toScreen("SimplexData: setMaxVT: Outside Bounds");
 }
@@ -258,22 +212,22 @@ void SimplexData::setMaxVT(const float** a, const int& numLev,
 {
     for ( int i = 0; i < numLev; i++)
         for(int j = 0; j < numRad; j++)
-            meanVT[i][j] = a[i][j];
+            meanVT[idx(i, j)] = a[i][j];
 }
 
 float SimplexData::getVTUncertainty(const int& lev, const int& rad) const
 {
     if((lev < numLevels)&&(rad < numRadii))
-        return meanVTUncertainty[lev][rad];
+        return meanVTUncertainty[idx(lev, rad)];
     Message::toScreen("SimplexData: getVTUncertainty: Outside Bounds");
-    return meanVTUncertainty[0][0];
+    return _fillv;
 }
 
 void SimplexData::setVTUncertainty(const int& lev, const int& rad, 
                                    const float& dMaxVT)
 {
     if ((lev < numLevels)&&(rad < numRadii))
-        meanVTUncertainty[lev][rad] = dMaxVT;
+        meanVTUncertainty[idx(lev, rad)] = dMaxVT;
     else
         Message::toScreen("SimplexData: setVTUncertainty: Outside Bounds");
 }
@@ -283,23 +237,23 @@ void SimplexData::setVTUncertainty(const float** a, const int& numLev,
 {
     for (int i = 0; i < numLev; i++)
         for (int j = 0; j < numRad; j++)
-            meanVTUncertainty[i][j] = a[i][j];
+            meanVTUncertainty[idx(i, j)] = a[i][j];
 }
 
 int SimplexData::getNumConvergingCenters(const int& lev, const int& rad) const
 {
     if((lev < numLevels) && (rad < numRadii))
-        return numConvergingCenters[lev][rad];
+        return numConvergingCenters[idx(lev, rad)];
     Message::toScreen("SimplexData: getNumConvergingCenters: Outside Bounds Level = " + QString().setNum(lev)
 		      + " radius = " + QString().setNum(rad));
-    return numConvergingCenters[0][0];
+    return _fillv;
 }
 
 void SimplexData::setNumConvergingCenters(const int& lev, const int& rad, 
                                           const int& num)
 {
     if((lev < numLevels)&&(rad < numRadii)&&(num < numPointsUsed)) {
-        numConvergingCenters[lev][rad] = num;
+        numConvergingCenters[idx(lev, rad)] = num;
         return;
     }
 
@@ -313,14 +267,14 @@ void SimplexData::setNumConvergingCenters(const int** a, const int& numLev,
 {
     for (int i = 0; i < numLev; i++)
         for (int j = 0; j < numRad; j++)
-            numConvergingCenters[i][j] = a[i][j];
+            numConvergingCenters[idx(i, j)] = a[i][j];
 }
 
 Center SimplexData::getCenter(const int& lev, const int& rad, 
                               const int& waveNum) const
 {
     if((lev < numLevels)&&(rad < numRadii)&&(waveNum < numCenters))
-        return centers[lev][rad][waveNum];
+        return centers[idx(lev, rad, waveNum)];
     Message::toScreen("SimplexData: getCenter: Outside Bounds");
     return Center();
 }
@@ -328,7 +282,10 @@ Center SimplexData::getCenter(const int& lev, const int& rad,
 void SimplexData::setCenter(const int& lev, const int& rad, 
                             const int& waveNum, const Center &newCenter)
 {
-    centers[lev][rad][waveNum] = newCenter;
+    if((lev < numLevels)&&(rad < numRadii)&&(waveNum < numCenters))
+        centers[idx(lev, rad, waveNum)] = newCenter;
+    else
+        Message::toScreen("SimplexData: setCenter: Outside Bounds");
 }
 
 int SimplexData::getNumPointsUsed() const
@@ -341,6 +298,19 @@ void SimplexData::setNumPointsUsed(const int& i)
     numPointsUsed = i;
 }
 
+int SimplexData::getNumPointsRefined() const
+{
+    // Every point is refined unless told otherwise
+    if (numPointsRefined > 0)
+        return numPointsRefined;
+    return numPointsUsed;
+}
+
+void SimplexData::setNumPointsRefined(const int& i)
+{
+    numPointsRefined = i;
+}
+
 bool SimplexData::operator ==(const SimplexData &other)
 {
     if(this->time == other.time)
@@ -365,13 +335,15 @@ bool SimplexData::operator > (const SimplexData &other)
 bool SimplexData::isNull()
 {
     if(time.isNull()) {
-        if(meanX[0][0] == _fillv)
-            if(meanY[0][0] == _fillv)
+        if(centers.empty())
+            return true;
+        if(meanX[0] == _fillv)
+            if(meanY[0] == _fillv)
                 if(height[0]== _fillv)
                     if(radius[0] == _fillv)
-                        if(meanVT[0][0] == _fillv)
-                            if(numConvergingCenters[0][0]==(int)_fillv)
-                                if(centers[0][0][0].isValid())
+                        if(meanVT[0] == _fillv)
+                            if(numConvergingCenters[0]==(int)_fillv)
+                                if(centers[0].isValid())
                                     return true;
     }
     return false;
@@ -380,22 +352,22 @@ bool SimplexData::isNull()
 bool SimplexData::emptyLevelRadius(const int& l, const int& r) const 
 {
     if((l < numLevels)&&(r < numRadii)){
-        if((meanX[l][r]==_fillv)||(meanY[l][r]==_fillv)
-                ||(centerStdDeviation[l][r]==_fillv)
-                ||(numConvergingCenters[l][r]==(int)_fillv)||(meanVT[l][r]==_fillv)
-                ||(meanVTUncertainty[l][r]==_fillv))
+        if((meanX[idx(l, r)]==_fillv)||(meanY[idx(l, r)]==_fillv)
+                ||(centerStdDeviation[idx(l, r)]==_fillv)
+                ||(numConvergingCenters[idx(l, r)]==(int)_fillv)||(meanVT[idx(l, r)]==_fillv)
+                ||(meanVTUncertainty[idx(l, r)]==_fillv))
             return true;
         return false;
     }
     return true;
 }
 
-void SimplexData::printString()
+void SimplexData::printString() const
 {
   std::cout << std::endl;
   std::cout << "Printing SimplexData" << std::endl;
   std::cout << "  time: " << getTime().toString(Qt::ISODate).toStdString() << std::endl;
-  for(int ii = 0; ii < 2; ii++) {
+  for(int ii = 0; (ii < 2) && (ii < numLevels); ii++) {
     std::cout << "  meanX @ level:" << ii << ": " << getMeanX(ii,0) << std::endl;
     std::cout << "  meanY @ level:" << ii << ": " << getMeanY(ii,0) << std::endl;
     std::cout << "  height @ level:" << ii << ": " << getHeight(ii) << std::endl;
@@ -417,38 +389,41 @@ void SimplexData::printString()
 void SimplexData::setNumLevels(int newNumLevels)
 {
     this->numLevels = newNumLevels;
+    allocate();
 }
 
 void SimplexData::setNumRadii(int newNumRadii)
 {
     this->numRadii = newNumRadii;
+    allocate();
 }
 
 void SimplexData::setNumCenters(int newNumCenters) 
 {
     this->numCenters = newNumCenters;
+    allocate();
 }
 
 float SimplexData::getInitialX(const int& level, const int& rad, 
                                const int& center) const
 {
-    return initialX[level][rad][center];
+    return initialX[idx(level, rad, center)];
 }
 
 float SimplexData::getInitialY(const int& level, const int& rad, 
                                const int& center) const
 {
-    return initialY[level][rad][center];
+    return initialY[idx(level, rad, center)];
 }
 
 void SimplexData::setInitialX( int& level,  int& rad, 
                                int& center,  float& value)
 {
-    initialX[level][rad][center] = value;
+    initialX[idx(level, rad, center)] = value;
 }
 
 void SimplexData::setInitialY( int& level,  int& rad, 
                                int& center,  float& value)
 {
-    initialY[level][rad][center] = value;
+    initialY[idx(level, rad, center)] = value;
 }
@@ -13,6 +13,7 @@
 
 #include "Center.h"
 #include <QDateTime>
+#include <vector>
 
 class SimplexData
 {
@@ -20,8 +21,8 @@ class SimplexData
 public:
     SimplexData();
     SimplexData(int availLevels, int availRadii, int availWaveNum);
-  //     SimplexData(const SimplexData& other);
-    ~SimplexData();
+    // Storage is held in std::vectors, so the compiler generated copy and
+    // move operations are used. Lists should move records in where possible.
 
     static constexpr float _fillv   = -999.0f;
 
@@ -67,6 +68,11 @@ public:
 
     int getNumPointsUsed() const;
     void setNumPointsUsed(const int& i);
+    // Starting points that were actually refined, fewer than the points
+    // used in a coarse search. Saved with the record as pointsRefined,
+    // SimplexList::restore() doesn't read records back yet.
+    int getNumPointsRefined() const;
+    void setNumPointsRefined(const int& i);
 
     bool operator ==(const SimplexData &other);
     bool operator < (const SimplexData &other);
@@ -80,6 +86,7 @@ public:
     static int getMaxRadii() { return MAXRADII; }
     static int getMaxCenters() { return MAXCENTERS; }
 
+    // Changing a dimension reallocates the storage and resets it to _fillv
     void setNumLevels(int newNumLevels);
     void setNumRadii(int newNumRadii);
     void setNumCenters(int newNumCenters);
@@ -93,10 +100,11 @@ public:
     bool isNull();
     bool emptyLevelRadius(const int& l, const int& r) const;
 
-    void printString();
+    void printString() const;
 
 private:
-    // static const int MAXLEVELS  = 15;
+    // These are the limits enforced by the configuration panels. The storage
+    // itself is sized to the levels, radii and centers actually searched.
     static const int MAXLEVELS  = 25;
     static const int MAXRADII   = 31;
     static const int MAXCENTERS = 25;
@@ -106,29 +114,38 @@ private:
     int numCenters;
 
     int numPointsUsed;
+    int numPointsRefined;
 
-    float initialX[MAXLEVELS][MAXRADII][MAXCENTERS];
-    float initialY[MAXLEVELS][MAXRADII][MAXCENTERS];
+    // All per level/radius/center arrays are stored contiguously with the
+    // level varying slowest, use the index helpers below to address them.
+    std::vector<float> initialX;
+    std::vector<float> initialY;
 
-    float meanX[MAXLEVELS][MAXRADII];
-    float meanY[MAXLEVELS][MAXRADII];
+    std::vector<float> meanX;
+    std::vector<float> meanY;
 
-    float height[MAXLEVELS];
-    float radius[MAXRADII];
+    std::vector<float> height;
+    std::vector<float> radius;
     // These two members hold absolute values of the distances the represent
     // since the area of interest might have non-interger units, or be offset
     // physically while still occupying the lowest index
 
-    float centerStdDeviation[MAXLEVELS][MAXRADII];
+    std::vector<float> centerStdDeviation;
 
-    int numConvergingCenters[MAXLEVELS][MAXRADII];
+    std::vector<int> numConvergingCenters;
 
     QDateTime time;
 
-    float meanVT[MAXLEVELS][MAXRADII];
-    float meanVTUncertainty[MAXLEVELS][MAXRADII];
+    std::vector<float> meanVT;
+    std::vector<float> meanVTUncertainty;
 
-    Center centers[MAXLEVELS][MAXRADII][MAXCENTERS];
+    std::vector<Center> centers;
+
+    void allocate();
+    int idx(const int& lev, const int& rad) const
+        { return lev * numRadii + rad; }
+    int idx(const int& lev, const int& rad, const int& center) const
+        { return (lev * numRadii + rad) * numCenters + center; }
 
 };
 
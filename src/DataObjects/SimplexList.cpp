@@ -13,6 +13,7 @@
 #include <QFileInfo>
 #include <QFile>
 #include <QXmlStreamWriter>
+#include <utility>
 
 SimplexList::SimplexList(QString filePath) : QList<SimplexData>()
 {
@@ -39,12 +40,13 @@ bool SimplexList::saveXML()
     xmlWriter.writeStartElement("vortex");
     xmlWriter.writeTextElement("hurricane",fileParts.at(0));
     xmlWriter.writeTextElement("radar",fileParts.at(1));
-    SimplexData *record=new SimplexData();
     QString tmpStr;
     for(int vid=0;vid<count();vid++){
         xmlWriter.writeStartElement("record");
-        *record=this->at(vid);
+        const SimplexData *record=&this->at(vid);
         xmlWriter.writeTextElement("time",record->getTime().toString("yyyy/MM/dd hh:mm:ss"));
+        xmlWriter.writeTextElement("pointsUsed",QString().setNum(record->getNumPointsUsed()));
+        xmlWriter.writeTextElement("pointsRefined",QString().setNum(record->getNumPointsRefined()));
         for(int hidx=0;hidx<record->getNumLevels();hidx++){
             xmlWriter.writeStartElement("level");
             xmlWriter.writeAttribute("height",QString().setNum(record->getHeight(hidx)));
@@ -68,7 +70,6 @@ bool SimplexList::saveXML()
         xmlWriter.writeEndElement();
     }
     xmlWriter.writeEndElement();
-    delete record;
     return true;
 }
 
@@ -82,8 +83,7 @@ void SimplexList::dump() const
 {
   for(int i = 0; i < count(); i++) {
     std::cout << "Simplex element at index " << i << std::endl;
-    SimplexData data = at(i);
-    data.printString();
+    at(i).printString();
   }
 }
 
@@ -94,9 +94,7 @@ void SimplexList::timeSort()
   for(int i = 0; i < count(); i++) {
     for(int j = i+1; j < count(); j++) {
       if(vals[i].getTime() > vals[j].getTime()) {
-        SimplexData tmp(vals[i]);
-        vals[i] = vals[j];
-        vals[i] = tmp;
+        std::swap(vals[i], vals[j]);
       }
     } // j
   } // i
@@ -0,0 +1,73 @@
+/*
+ * VolumeCache.cpp
+ * VORTRAC
+ *
+ */
+
+#include "VolumeCache.h"
+
+#include <QFileInfo>
+#include <QTextStream>
+
+SharedCache<RadarData>& VolumeCache::volumes()
+{
+    // Nothing is held on to until a second analysis starts
+    static SharedCache<RadarData> cache(0);
+    return cache;
+}
+
+SharedCache<SharedGrid>& VolumeCache::grids()
+{
+    static SharedCache<SharedGrid> cache(0);
+    return cache;
+}
+
+void VolumeCache::analysisStarted()
+{
+    countAnalyses(1);
+}
+
+void VolumeCache::analysisFinished()
+{
+    countAnalyses(-1);
+}
+
+void VolumeCache::countAnalyses(int change)
+{
+    static QMutex mutex;
+    static int analyses = 0;
+    QMutexLocker locker(&mutex);
+    analyses += change;
+    // One recent volume for each of the other analyses
+    volumes().setKeep(qMax(0, analyses - 1));
+}
+
+QString VolumeCache::volumeKey(const QStringList &files, const QDomElement &radar,
+                               const QDomElement &qc)
+{
+    // A file rewritten in place is a different volume
+    QString key;
+    for (int i = 0; i < files.size(); i++) {
+        QFileInfo info(files.at(i));
+        key += info.absoluteFilePath() + ":" + QString::number(info.size()) + ":"
+            + QString::number(info.lastModified().toMSecsSinceEpoch()) + ";";
+    }
+    return key + "|" + elementKey(radar) + "|" + elementKey(qc);
+}
+
+QString VolumeCache::gridKey(const QString &volumeKey, const QDomElement &cappi,
+                             float centerLat, float centerLon)
+{
+    return volumeKey + "|" + elementKey(cappi) + "|"
+        + QString::number(centerLat, 'f', 4) + "," + QString::number(centerLon, 'f', 4);
+}
+
+QString VolumeCache::elementKey(const QDomElement &element)
+{
+    QString text;
+    if (element.isNull())
+        return text;
+    QTextStream stream(&text);
+    element.save(stream, 0);
+    return text;
+}
@@ -0,0 +1,149 @@
+/*
+ * VolumeCache.h
+ * VORTRAC
+ *
+ * Radar volumes and CAPPIs shared between the analyses running in one
+ * process. When two storms, or a storm and a diagnostic run, are tracked
+ * from the same radar, the volume is read and quality controlled once, and
+ * a CAPPI with the same grid is only interpolated once.
+ *
+ */
+
+#ifndef VOLUMECACHE_H
+#define VOLUMECACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QPair>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QDomElement>
+
+#include "Radar/RadarData.h"
+#include "DataObjects/GriddedData.h"
+
+// Entries are handed out as shared pointers and live as long as somebody
+// uses them. The most recent few are also held on to, so an analysis that
+// gets to a volume a little after the others still finds it.
+template <class T>
+class SharedCache
+{
+
+public:
+    explicit SharedCache(int keep) : _keep(keep) {}
+
+    // How many recent entries to hold on to
+    void setKeep(int keep)
+    {
+        QMutexLocker locker(&_mutex);
+        _keep = keep;
+        while (_recent.size() > _keep)
+            _recent.removeLast();
+    }
+
+    // Returns the entry for the key. When there is none, returns null and
+    // the caller has to build it and insert() it, or abandon() the key.
+    // When another analysis is building it, waits for that one.
+    QSharedPointer<T> claim(const QString &key)
+    {
+        QMutexLocker locker(&_mutex);
+        forever {
+            QSharedPointer<T> entry = _entries.value(key).toStrongRef();
+            if (!entry.isNull()) {
+                keepRecent(key, entry);
+                return entry;
+            }
+            if (!_building.contains(key))
+                break;
+            _built.wait(&_mutex);
+        }
+        _entries.remove(key);
+        _building.insert(key);
+        return QSharedPointer<T>();
+    }
+
+    void insert(const QString &key, const QSharedPointer<T> &entry)
+    {
+        QMutexLocker locker(&_mutex);
+        _building.remove(key);
+        _entries.insert(key, entry.toWeakRef());
+        keepRecent(key, entry);
+        _built.wakeAll();
+    }
+
+    // The build failed, let the next one waiting have a go
+    void abandon(const QString &key)
+    {
+        QMutexLocker locker(&_mutex);
+        _building.remove(key);
+        _built.wakeAll();
+    }
+
+private:
+    void keepRecent(const QString &key, const QSharedPointer<T> &entry)
+    {
+        for (int i = 0; i < _recent.size(); i++) {
+            if (_recent.at(i).first == key) {
+                _recent.removeAt(i);
+                break;
+            }
+        }
+        if (_keep > 0)
+            _recent.prepend(qMakePair(key, entry));
+        while (_recent.size() > _keep)
+            _recent.removeLast();
+    }
+
+    QMutex _mutex;
+    QWaitCondition _built;
+    QHash<QString, QWeakPointer<T> > _entries;
+    QSet<QString> _building;
+    QList<QPair<QString, QSharedPointer<T> > > _recent;
+    int _keep;
+};
+
+// A CAPPI shared by several analyses. The center finding and VTD move the
+// grid reference point around, so only one analysis at a time works on it.
+class SharedGrid
+{
+
+public:
+    SharedGrid(GriddedData *grid) : grid(grid) {}
+    ~SharedGrid() { delete grid; }
+
+    GriddedData *grid;
+    QMutex inUse;
+};
+
+class VolumeCache
+{
+
+public:
+    // Read and quality controlled radar volumes
+    static SharedCache<RadarData>& volumes();
+    // CAPPIs, only held while in use, a grid is a lot of memory
+    static SharedCache<SharedGrid>& grids();
+
+    // Analyses come and go through these. Recent volumes are only held
+    // on to while more than one analysis runs, for the ones lagging behind.
+    static void analysisStarted();
+    static void analysisFinished();
+
+    // Same files, radar and QC configuration give the same volume
+    static QString volumeKey(const QStringList &files, const QDomElement &radar,
+                             const QDomElement &qc);
+    // Same volume, CAPPI configuration and center give the same grid
+    static QString gridKey(const QString &volumeKey, const QDomElement &cappi,
+                           float centerLat, float centerLon);
+
+private:
+    static QString elementKey(const QDomElement &element);
+    static void countAnalyses(int change);
+};
+
+#endif
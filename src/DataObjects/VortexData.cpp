@@ -75,45 +75,6 @@ VortexData::VortexData(int availLevels, int availRadii, int availWaveNum)
     _maxValidRadius = -999;
 }
 
-// VortexData::VortexData(const VortexData &other)
-// {
-//     this->_numLevels = other._numLevels;
-//     this->_numRadii  = other._numRadii;
-//     this->_numWaveNum = other._numWaveNum;
-//     this->_bestLevel = other._bestLevel;
-    
-//     for(int i = 0; i < _numLevels; i++)
-//     {
-//         this->_centerLat[i] = other._centerLat[i];
-//         this->_centerLon[i] = other._centerLon[i];
-//         this->_centerAlt[i] = other._centerAlt[i];
-//         this->_maxVT[i] = other._maxVT[i];
-//         this->_RMW[i] = other._RMW[i];
-//         this->_RMWUncertainty[i] = other._RMWUncertainty[i];
-//         this->_centerSD[i] = other._centerSD[i];
-//         for(int j = 0; j < _numRadii; j++) {
-//             for(int k = 0; k < _numWaveNum; k++) {
-//                 this->coefficients[i][j][k] = coefficients[i][j][k];
-//             }
-//         }
-//     }
-
-//     this->_time = other._time;
-
-//     this->centralPressure = other.centralPressure;
-//     this->centralPressureUncertainty = other.centralPressureUncertainty;
-//     this->pressureDeficit = other.pressureDeficit;
-//     this->pressureDeficitUncertainty = other.pressureDeficitUncertainty;
-// 	this->maxSfcWind = other.maxSfcWind;
-//     this->_aveRMW = other._aveRMW;
-//     this->_aveRMWUncertainty = other._aveRMWUncertainty;
-//     this->_maxValidRadius = other._maxValidRadius;
-// }
-
-VortexData::~VortexData()
-{
-}
-
 // TODO
 // This would be a lot simpler if the VortexData had access to minlevel, maxlevel, and grid spacing...
 
@@ -146,17 +107,19 @@ int VortexData::getHeightIndex(const float& height) const
 Coefficient VortexData::getCoefficient(const int& lev, const int& rad, 
                                        const int& waveNum) const
 {
-    return coefficients[lev][rad][waveNum];
+    if((lev < 0) || (rad < 0) || (rad >= _numRadii) ||
+       (waveNum < 0) || (waveNum >= getNumCoefficients()))
+        return Coefficient();
+    int index = coefficientIndex(lev, rad, waveNum);
+    if(index >= (int)_coefficients.size())
+        return Coefficient();
+    return _coefficients[index];
 }
 
 Coefficient VortexData::getCoefficient(const int& lev, const int& rad,
                                        const QString& parameter) const
 {
-    for(int i = 0; i < _numWaveNum; i++) {
-        if(coefficients[lev][rad][i].getParameter() == parameter)
-            return coefficients[lev][rad][i];
-    }
-    return Coefficient();
+    return getCoefficientById(lev, rad, Coefficient::parameterId(parameter));
 }
 
 Coefficient VortexData::getCoefficient(const float& height, const int& rad,
@@ -172,24 +135,126 @@ Coefficient VortexData::getCoefficient(const float& height, const int& rad,
 
 Coefficient VortexData::getCoefficient(const float& height, const float& rad,
                                        const QString& parameter) const
+{
+    return getCoefficientById(height, rad, Coefficient::parameterId(parameter));
+}
+
+Coefficient VortexData::getCoefficientById(const int& lev, const int& rad,
+                                           const int& parameterId) const
+{
+    if((lev < 0) || (rad < 0) || (rad >= _numRadii))
+        return Coefficient();
+    int numCoeffs = getNumCoefficients();
+    int index = coefficientIndex(lev, rad, 0);
+    if(index + numCoeffs > (int)_coefficients.size())
+        return Coefficient();
+    for(int i = 0; i < numCoeffs; i++) {
+        if(_coefficients[index + i].getParameterId() == parameterId)
+            return _coefficients[index + i];
+    }
+    return Coefficient();
+}
+
+Coefficient VortexData::getCoefficientById(const float& height, const float& rad,
+                                           const int& parameterId) const
 {
     int level = getHeightIndex(height);
     if (level < 0) return Coefficient();
-    float minRad = getCoefficient(level, 0, parameter).getRadius();
-    if(minRad == -999)
-        minRad = 0;
-    int radIndex = int(rad - minRad);
+    int radIndex = getRingIndex(rad);
     if((level == -1) || (radIndex < 0 ) || (radIndex > _numRadii)) {
         //Message::toScreen("VortexData: GetCoefficient(4): Can't Get Needed Indices: Level = "+QString().setNum(level)+" radIndex = "+QString().setNum(radIndex));
         return Coefficient();
     }
-    return getCoefficient(level, radIndex, parameter);
+    return getCoefficientById(level, radIndex, parameterId);
+}
+
+int VortexData::componentSlot(const int& parameterId)
+{
+    int component = parameterId >> 8;
+    int trig = (parameterId >> 7) & 1;
+    int waveNum = parameterId & 0x7f;
+    if((component < Coefficient::VT) || (component > Coefficient::VM) || (waveNum > MAXWAVENUM))
+        return -1;
+    return ((component - Coefficient::VT) * 2 + trig) * (MAXWAVENUM + 1) + waveNum;
+}
+
+int VortexData::getRingIndex(const float& rad) const
+{
+    // Rings are 1 km apart starting from the radius of ring 0
+    float minRad = 0;
+    if(!_ringRadius.empty() && (_ringRadius[0] != _fillv))
+        minRad = _ringRadius[0];
+    return int(rad - minRad);
+}
+
+float VortexData::getComponent(const int& lev, const int& rad, const int& parameterId) const
+{
+    int slot = componentSlot(parameterId);
+    if((slot < 0) || (lev < 0) || (rad < 0) || (rad >= _numRadii))
+        return _fillv;
+    const std::vector<float> &values = _components[slot];
+    int index = lev * _numRadii + rad;
+    if(index >= (int)values.size())
+        return _fillv;
+    return values[index];
+}
+
+float VortexData::getComponent(const float& height, const float& rad, const int& parameterId) const
+{
+    int level = getHeightIndex(height);
+    if(level < 0)
+        return _fillv;
+    return getComponent(level, getRingIndex(rad), parameterId);
 }
 
 void VortexData::setCoefficient(const int& lev, const int& rad, 
                                 const int& coeffNum, const Coefficient &coefficient)
 {
-    coefficients[lev][rad][coeffNum] = coefficient;
+    if((lev < 0) || (rad < 0) || (rad >= _numRadii) ||
+       (coeffNum < 0) || (coeffNum >= getNumCoefficients()))
+        return;
+    // Grow the storage a whole level at a time
+    int levelSize = _numRadii * getNumCoefficients();
+    if((int)_coefficients.size() < (lev + 1) * levelSize)
+        _coefficients.resize((lev + 1) * levelSize);
+    _coefficients[coefficientIndex(lev, rad, coeffNum)] = coefficient;
+
+    // Keep the dense component copy in step
+    int slot = componentSlot(coefficient.getParameterId());
+    if(slot < 0)
+        return;
+    std::vector<float> &values = _components[slot];
+    if((int)values.size() < (lev + 1) * _numRadii)
+        values.resize((lev + 1) * _numRadii, _fillv);
+    values[lev * _numRadii + rad] = coefficient.getValue();
+    if((int)_ringRadius.size() < _numRadii)
+        _ringRadius.resize(_numRadii, _fillv);
+    if(coefficient.getRadius() != _fillv)
+        _ringRadius[rad] = coefficient.getRadius();
+}
+
+void VortexData::clearCoefficients()
+{
+    _coefficients.clear();
+    for(int i = 0; i < NUMCOMPONENTS; i++)
+        _components[i].clear();
+    _ringRadius.clear();
+}
+
+void VortexData::setNumRadii(const int& num)
+{
+    if((num > MAXRADII) || (num == _numRadii))
+        return;
+    _numRadii = num;
+    clearCoefficients();
+}
+
+void VortexData::setNumWaveNum(const int& num)
+{
+    if((num > MAXWAVENUM) || (num == _numWaveNum))
+        return;
+    _numWaveNum = num;
+    clearCoefficients();
 }
 
 bool VortexData::operator ==(const VortexData &other)
@@ -221,9 +286,11 @@ void VortexData::saveCoefficients(QString &fname)
 
   outfile << "# Vortex time: " << getTime().toString("yyyy-MM-dd:hh:mm").toLatin1().data() << std::endl;
 
-    for(int lev = 0; lev < _numLevels; lev++)
+    int levelSize = _numRadii * getNumCoefficients();
+    int numStoredLevels = (levelSize > 0) ? _coefficients.size() / levelSize : 0;
+    for(int lev = 0; lev < numStoredLevels; lev++)
       for(int rad = 0; rad < _numRadii; rad++)
-	for(int wave = 0; wave < _numWaveNum; wave++) {
+	for(int wave = 0; wave < getNumCoefficients(); wave++) {
 	  Coefficient current = getCoefficient(lev, rad, wave);
 	  if(current.getValue() <= _fillv)
 	    continue;
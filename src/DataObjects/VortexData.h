@@ -13,6 +13,7 @@
 
 #include "Coefficient.h"
 #include <QDateTime>
+#include <vector>
 
 class VortexData
 {
@@ -20,8 +21,8 @@ class VortexData
 public:
     VortexData();
     VortexData(int availLevels, int availRadii, int availWaveNum);
-  // VortexData(const VortexData &other); use compiler copy constructor
-    ~VortexData();
+    // Use the compiler copy and move operations, the coefficients live in a
+    // std::vector so a VortexData can be moved into a VortexList cheaply.
 
     static constexpr float _fillv  =-999.0f;
 
@@ -87,7 +88,15 @@ public:
     Coefficient getCoefficient(const int& lev, const int& rad,const QString& parameter) const;
     Coefficient getCoefficient(const float& height, const int& rad,const QString& parameter) const;
     Coefficient getCoefficient(const float& height, const float& rad,const QString& parameter) const;
+    // Look up by Coefficient::parameterId, these avoid any string handling
+    Coefficient getCoefficientById(const int& lev, const int& rad, const int& parameterId) const;
+    Coefficient getCoefficientById(const float& height, const float& rad, const int& parameterId) const;
     void	setCoefficient(const int& lev, const int& rad,const int& coeffNum, const Coefficient &coefficient);
+    // Value of one component (Coefficient::parameterId) read straight from
+    // the dense per-component arrays, _fillv if it was never set
+    float getComponent(const int& lev, const int& rad, const int& parameterId) const;
+    float getComponent(const float& height, const float& rad, const int& parameterId) const;
+    int   getRingIndex(const float& rad) const;
     void	saveCoefficients(QString &fname);
 
     // void operator = (const VortexData &other);
@@ -100,8 +109,10 @@ public:
     inline int getNumWaveNum() const { return _numWaveNum; }
 
     inline void setNumLevels(const int& num)  { if(num <= MAXLEVELS)  _numLevels = num; }
-    inline void setNumRadii(const int& num)   { if(num <= MAXRADII)   _numRadii = num; }
-    inline void setNumWaveNum(const int& num) { if(num <= MAXWAVENUM) _numWaveNum = num; }
+    // Changing the ring or wavenumber dimensions discards any stored coefficients
+    void setNumRadii(const int& num);
+    void setNumWaveNum(const int& num);
+    inline int getNumCoefficients() const { return _numWaveNum * 2 + 1; }
 
     static int getMaxLevels()  { return MAXLEVELS; }
     static int getMaxRadii()   { return MAXRADII; }
@@ -111,10 +122,12 @@ public:
     inline void setBestLevel(int l)	{ _bestLevel = l; }
     
 private:
-    // static const int MAXLEVELS  = 15;
+    // These are the limits enforced by the configuration panels
     static const int MAXLEVELS  = 25;
     static const int MAXRADII   = 151;
     static const int MAXWAVENUM = 7;  // was 5
+    // VT, VR and VM, each cos and sin, for every wavenumber
+    static const int NUMCOMPONENTS = 3 * 2 * (MAXWAVENUM + 1);
 
     int _numLevels;
     int _numRadii;
@@ -128,7 +141,20 @@ private:
     float _RMW[MAXLEVELS];
     float _RMWUncertainty[MAXLEVELS];
     float _centerSD[MAXLEVELS];
-    Coefficient coefficients[MAXLEVELS][MAXRADII][MAXWAVENUM*2+3];
+
+    // Coefficients are stored contiguously as [level][ring][coefficient].
+    // Storage only grows to the levels that have been set, so records for
+    // volumes without a wind retrieval carry no coefficient storage at all.
+    std::vector<Coefficient> _coefficients;
+    int coefficientIndex(const int& lev, const int& rad, const int& coeffNum) const
+        { return (lev * _numRadii + rad) * getNumCoefficients() + coeffNum; }
+
+    // The same values split out per component as [level][ring] floats,
+    // grown a level at a time like the coefficients
+    std::vector<float> _components[NUMCOMPONENTS];
+    std::vector<float> _ringRadius;
+    static int componentSlot(const int& parameterId);
+    void clearCoefficients();
 
     QDateTime _time;
     float _maxValidRadius;
@@ -16,6 +16,7 @@
 #include <QString>
 #include <math.h>
 #include <iostream>
+#include <utility>
 #include "VortexList.h"
 
 
@@ -85,9 +86,7 @@ void VortexList::timeSort()
   for(int i = 0; i < count(); i++) {
     for(int j = i+1; j < count(); j++) {
       if(vals[i].getTime() > vals[j].getTime()) {
-        VortexData tmp(vals[i]);
-        vals[i] = vals[j];
-        vals[i] = tmp;
+        std::swap(vals[i], vals[j]);
       }
     } // j
   } // i
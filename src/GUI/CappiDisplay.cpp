@@ -365,18 +365,16 @@ void CappiDisplay::constructImage(const GriddedData& cappi)
     hasCappi = true;
     imageHolder.lock();
     //hasGBVTDInfo = false;
-    image.fill(qRgb(255, 255, 255));
     iDim = (int)cappi.getIdim();
     jDim = (int)cappi.getJdim();
     QSize cappiSize((int)iDim,(int)jDim);
-    image = image.scaled(cappiSize);
 
     // Get the minimum and maximum Doppler velocities
     maxVel = -9999;
     minVel= 9999;
     
     float k = getDisplayLevel();
-      
+
     QString velfield("ve");
     QString dbzfield("dz");
     QString heightfield("ht");
@@ -402,25 +400,42 @@ void CappiDisplay::constructImage(const GriddedData& cappi)
     float maxAppYindex = -999.0;
     float maxRecXindex = -999.0;
     float maxRecYindex = -999.0;
-    for (float i = minI; i < maxI; i++) {
-        for (float j = minJ; j < maxJ; j++) {
-            float vel = cappi.getIndexValue(velfield,i,j,k);
-            if (vel != -999) {
-	        vel *= 1.9438445;
-                if (vel > maxVel) {
-                    maxVel = vel;
-                    maxRecXindex = i;
-                    maxRecYindex = j;
-                    maxVelXpercent = (i+1)/iDim;
-                    maxVelYpercent = (j+1)/jDim;
-                }
-                if (vel < minVel) {
-                    minVel = vel;
-                    maxAppXindex = i;
-                    maxAppYindex = j;
-                    minVelXpercent = (i+1)/iDim;
-                    minVelYpercent = (j+1)/jDim;
-                }
+
+    // Take the display level of each field once, rows of constant j with i
+    // varying fastest, so that both passes below walk contiguous memory
+    int nx = iDim;
+    int ny = jDim;
+    QVector<float> velSlice(nx*ny);
+    cappi.getIndexSlice(velfield, (int)k, velSlice.data());
+
+    // Convert to knots and find the extremes inside the search area in the
+    // same pass
+    int iStart = (int)minI;
+    int jStart = (int)minJ;
+    for (int j = 0; j < ny; j++) {
+        float* row = velSlice.data() + j*nx;
+        bool inRows = (j >= jStart) && (j < maxJ);
+        for (int i = 0; i < nx; i++) {
+            float vel = row[i];
+            if (vel == -999)
+                continue;
+            vel *= 1.9438445;
+            row[i] = vel;
+            if (!inRows || (i < iStart) || (i >= maxI))
+                continue;
+            if (vel > maxVel) {
+                maxVel = vel;
+                maxRecXindex = i;
+                maxRecYindex = j;
+                maxVelXpercent = (i+1.0)/iDim;
+                maxVelYpercent = (j+1.0)/jDim;
+            }
+            if (vel < minVel) {
+                minVel = vel;
+                maxAppXindex = i;
+                maxAppYindex = j;
+                minVelXpercent = (i+1.0)/iDim;
+                minVelYpercent = (j+1.0)/jDim;
             }
         }
     }
@@ -481,28 +496,33 @@ void CappiDisplay::constructImage(const GriddedData& cappi)
         field = dbzfield;
         minValue = -11.5;
     }
-    // Set each pixel color scaled to the max and min ranges
-    for (float i = 0; i < iDim; i++) {
-        for (float j = 0; j < jDim; j++) {
-            float value = cappi.getIndexValue(field,i,j,k);
-            int color = 1;
-            if (value == -999) {
-                color = 0;
-            } else {
-				if (displayType == velocity) value *= 1.9438445;				
-                color = (int)((value - minValue)/contourIncr) + 2;
-                if ((color < 0) or (color > 43)) {
-                    // Bad color
-                    color = 1;
-                }
-            }
-            int x = (int)i;
-            int y = (int)(jDim-j-1);
-            if (image.valid(x,y)) {
-                image.setPixel(x,y,color);
+    QVector<float> dbzSlice;
+    const float* values = velSlice.constData();
+    if (displayType != velocity) {
+        dbzSlice.resize(nx*ny);
+        cappi.getIndexSlice(field, (int)k, dbzSlice.data());
+        values = dbzSlice.constData();
+    }
+
+    // Set each pixel color scaled to the max and min ranges, writing the
+    // color index straight into the scan lines (north is up)
+    QImage cappiImage(cappiSize, QImage::Format_Indexed8);
+    cappiImage.setColorTable(image.colorTable());
+    float colorScale = 1.0/contourIncr;
+    for (int j = 0; j < ny; j++) {
+        const float* row = values + j*nx;
+        uchar* line = cappiImage.scanLine(ny-j-1);
+        for (int i = 0; i < nx; i++) {
+            float value = row[i];
+            int color = (int)((value - minValue)*colorScale) + 2;
+            if ((color < 0) or (color > 43)) {
+                // Bad color
+                color = 1;
             }
+            line[i] = (value == -999) ? 0 : color;
         }
     }
+    image = cappiImage;
 
     // TODO
     // Support the ability to have different image size on the config.
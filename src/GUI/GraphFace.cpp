@@ -173,8 +173,8 @@ bool GraphFace::event(QEvent *e)
     if(index != -1) {
       if(ONDropSonde) {
 	// Drop Sonde Measurement
-	measurement.setNum(dropList->value(index).getPressure());
-	time = dropList->value(index).getTime().toString("dd-hh:mm");
+	measurement.setNum(dropList->at(index).getPressure());
+	time = dropList->at(index).getTime().toString("dd-hh:mm");
 	QString message("DropWindSonde\nPressure = "
 			+ measurement + " mb\n" + time);
 	QToolTip::showText(find->globalPos(), message, this);
@@ -182,8 +182,8 @@ bool GraphFace::event(QEvent *e)
       else {
 	if ((unScalePressure(find->y()) > (pGMin)) && showPressure) {
 	  // Pressure Point
-	  measurement.setNum(VortexDataList->value(index).getPressure(), 'f', 0);
-	  time = VortexDataList->value(index).getTime().toString("dd-hh:mm");
+	  measurement.setNum(VortexDataList->at(index).getPressure(), 'f', 0);
+	  time = VortexDataList->at(index).getTime().toString("dd-hh:mm");
 	  QString message("Pressure Estimate\nPressure = "
 			  + measurement + " mb\n"+ time);
 	  //			  +"\nClick For More Info...");
@@ -192,8 +192,8 @@ bool GraphFace::event(QEvent *e)
 	else {
 	  if((unScaleDeficit(find->y()) > (dGMin)) && !showPressure) {
 	    // Deficit Point
-	    measurement.setNum(VortexDataList->value(index).getPressureDeficit());
-	    time = VortexDataList->value(index).getTime().toString("dd-hh:mm");
+	    measurement.setNum(VortexDataList->at(index).getPressureDeficit());
+	    time = VortexDataList->at(index).getTime().toString("dd-hh:mm");
 	    QString message("Pressure Deficit Estimate\nPressure Deficit = "
 			    + measurement +" mb\n"+ time);
 	    //              + "\nClick For More Info...");
@@ -201,8 +201,8 @@ bool GraphFace::event(QEvent *e)
 	  }
 	  else {
 	    // RMW Point
-	    measurement.setNum(VortexDataList->value(index).getAveRMWnm(), 'f', 0);
-	    time = VortexDataList->value(index).getTime().toString("dd-hh:mm");
+	    measurement.setNum(VortexDataList->at(index).getAveRMWnm(), 'f', 0);
+	    time = VortexDataList->at(index).getTime().toString("dd-hh:mm");
 	    QString message("Radius of Maximum Wind Estimate\nRMW = "
 			    +measurement+" nm\n"+time);
 	    QToolTip::showText(find->globalPos(), message , this);
@@ -341,7 +341,7 @@ void GraphFace::newInfo(VortexList* gList)
     first = gList->at(0).getTime();
    
   for(int i = 0; i < gList->count(); i++) {
-    VortexData new_point = gList->value(i);
+    const VortexData &new_point = gList->at(i);
  
     checkPressure(&new_point);
     checkDeficit(&new_point);
@@ -377,7 +377,7 @@ void GraphFace::newDropSonde(VortexList* dropPointer)
   // Checks the Drop Wind Sonde pressure values to make sure they don't 
   // change the range
 {
-  VortexData new_drop = dropPointer->last(); 
+  const VortexData &new_drop = dropPointer->last(); 
   checkPressure(&new_drop);
   checkDeficit(&new_drop);
   checkRanges();
@@ -722,7 +722,7 @@ void GraphFace::checkRanges()
   }
 }
 
-void GraphFace::checkPressure(VortexData* point)
+void GraphFace::checkPressure(const VortexData* point)
 {
 	
   if ((point->getPressure() + 
@@ -750,7 +750,7 @@ void GraphFace::checkPressure(VortexData* point)
   } 
 }
 
-void GraphFace::checkDeficit(VortexData* point)
+void GraphFace::checkDeficit(const VortexData* point)
 {
 	
   if ((-1*point->getPressureDeficit() + 
@@ -777,7 +777,7 @@ void GraphFace::checkDeficit(VortexData* point)
   } 
 }
 
-void GraphFace::checkRmw(VortexData* point)
+void GraphFace::checkRmw(const VortexData* point)
 {
   
   // We want to get statistics on all the rmws and then take the average
@@ -806,7 +806,7 @@ void GraphFace::checkRmw(VortexData* point)
 
 }
 
-QPointF GraphFace::makePressurePoint(VortexData d)
+QPointF GraphFace::makePressurePoint(const VortexData& d)
 {
   // take in data from newInfo and creates graphable point using real data 
   // (mbar -> QPointF)
@@ -820,7 +820,7 @@ QPointF GraphFace::makePressurePoint(VortexData d)
   return (temp);
 }
 
-QPointF GraphFace::makeDeficitPoint(VortexData d)
+QPointF GraphFace::makeDeficitPoint(const VortexData& d)
 {
   // take in data from newInfo and creates graphable point using real data 
   // (mbar -> QPointF)
@@ -834,7 +834,7 @@ QPointF GraphFace::makeDeficitPoint(VortexData d)
   return (temp);
 }
 
-QPointF GraphFace::makeRmwPoint(VortexData d)
+QPointF GraphFace::makeRmwPoint(const VortexData& d)
 {
 
   // This constructs a RMW point in the right scale cooresponding to the
@@ -851,7 +851,7 @@ QPointF GraphFace::makeRmwPoint(VortexData d)
   return(temp);
 }
 
-QPointF GraphFace::makeRmwPoint(VortexData d, int bestLevel)
+QPointF GraphFace::makeRmwPoint(const VortexData& d, int bestLevel)
 {
 
   // This constructs a RMW point in the right scale cooresponding to the
@@ -869,7 +869,7 @@ QPointF GraphFace::makeRmwPoint(VortexData d, int bestLevel)
   return(temp);
 }
 
-QPointF GraphFace::makeRmwPoint(VortexData d, float rmw)
+QPointF GraphFace::makeRmwPoint(const VortexData& d, float rmw)
 {
   // This constructs a RMW point in the right scale for a given radius of 
   // maximum wind (rmw) is the case that we are not using a specific level
@@ -1375,7 +1375,7 @@ QPainter* GraphFace::updateImage(QPainter* painter)
 	//-------------------------------ErrorBars----------------------------
 	
 	// This draws the errorbars about the point 
-	QPointF xypoint = makePressurePoint(VortexDataList->value(i));
+	QPointF xypoint = makePressurePoint(VortexDataList->at(i));
 	
 	if(!xypoint.isNull()) {
 	  if (VortexDataList->at(i).getPressureUncertainty()>0) {                           // if uncertainty = 0 there are no bars
@@ -1461,8 +1461,8 @@ QPainter* GraphFace::updateImage(QPainter* painter)
       // to the previous one with a line
       int j = 1;
       while(j < VortexDataList->size())	{
-	QPointF point1 = makePressurePoint(VortexDataList->value(j-1));
-	QPointF point2 = makePressurePoint(VortexDataList->value(j));
+	QPointF point1 = makePressurePoint(VortexDataList->at(j-1));
+	QPointF point2 = makePressurePoint(VortexDataList->at(j));
 	if(!point1.isNull()&&!point2.isNull())
 	  painter->drawLine(point1, point2);
 	j++;
@@ -1476,7 +1476,7 @@ QPainter* GraphFace::updateImage(QPainter* painter)
 	//-------------------------------ErrorBars----------------------------
 	
 	// This draws the errorbars about the point 
-	QPointF xypoint = makeDeficitPoint(VortexDataList->value(i));
+	QPointF xypoint = makeDeficitPoint(VortexDataList->at(i));
 	
 	if(!xypoint.isNull()) {
 	  if (VortexDataList->at(i).getDeficitUncertainty()>0) {                           // if uncertainty = 0 there are no bars
@@ -1561,8 +1561,8 @@ QPainter* GraphFace::updateImage(QPainter* painter)
       // to the previous one with a line
       int j = 1;
       while(j < VortexDataList->size())	{
-	QPointF point1 = makeDeficitPoint(VortexDataList->value(j-1));
-	QPointF point2 = makeDeficitPoint(VortexDataList->value(j));
+	QPointF point1 = makeDeficitPoint(VortexDataList->at(j-1));
+	QPointF point2 = makeDeficitPoint(VortexDataList->at(j));
 	if(!point1.isNull()&&!point2.isNull())
 	  painter->drawLine(point1, point2);
 	j++;
@@ -1679,8 +1679,8 @@ QPainter* GraphFace::updateImage(QPainter* painter)
       //connects all the rmw points together with lines to the previous point
       int i = 1;
       while(i<VortexDataList->count()) {
-	QPointF point1 = makeRmwPoint(VortexDataList->value(i-1));
-	QPointF point2 = makeRmwPoint(VortexDataList->value(i));
+	QPointF point1 = makeRmwPoint(VortexDataList->at(i-1));
+	QPointF point2 = makeRmwPoint(VortexDataList->at(i));
 	if(!point1.isNull()&&!point2.isNull())
 	  painter->drawLine(point1,point2);
 	i++;
@@ -1698,7 +1698,7 @@ QPainter* GraphFace::updateImage(QPainter* painter)
 
       painter->setBrush(dropBrush);
       for (int i = 0; i < dropList->size();i++) {
-	QPointF xypoint = makePressurePoint(dropList->value(i));
+	QPointF xypoint = makePressurePoint(dropList->at(i));
 	if(!xypoint.isNull()) {
 	  drop.moveCenter(xypoint);
 	  painter->drawEllipse(drop);
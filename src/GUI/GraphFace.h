@@ -150,11 +150,11 @@ private:
     // These functions use information within the list of data points
     // to create a point that is scaled to the current ranges that the graph covers
     // when this point is returned it is ready to graph
-    QPointF makePressurePoint(VortexData d);
-    QPointF makeDeficitPoint(VortexData d);
-    QPointF makeRmwPoint(VortexData d);
-    QPointF makeRmwPoint(VortexData d, int bestLevel);
-    QPointF makeRmwPoint(VortexData d, float rmw);
+    QPointF makePressurePoint(const VortexData& d);
+    QPointF makeDeficitPoint(const VortexData& d);
+    QPointF makeRmwPoint(const VortexData& d);
+    QPointF makeRmwPoint(const VortexData& d, int bestLevel);
+    QPointF makeRmwPoint(const VortexData& d, float rmw);
 
     // These functions are used to scale each of the variable to their relative position in
     // the current variable ranges on the graph
@@ -177,9 +177,9 @@ private:
     // this function checks to see if the ranges need to be update
     // it will also update ranges when necessary
     void checkRanges();
-    void checkPressure(VortexData* point);
-    void checkRmw(VortexData* point);
-    void checkDeficit(VortexData* point);
+    void checkPressure(const VortexData* point);
+    void checkRmw(const VortexData* point);
+    void checkDeficit(const VortexData* point);
 
     // Constants related to the absolute size of the margins and face of the graph
     // These are in Qt sizes not scaled sizes
@@ -434,6 +434,7 @@ RadarPanel::RadarPanel():AbstractPanel()
     radarFormatOptions->insert(QString("NCDC Level II"), QString("NCDCLEVELII"));
     radarFormatOptions->insert(QString("LDM Level II"), QString("LDMLEVELII"));
     radarFormatOptions->insert(QString("NetCDF"), QString("NETCDF"));
+    radarFormatOptions->insert(QString("DORADE Sweeps"), QString("DORADE"));
     //radarFormatOptions->insert(QString("Analytic Model"), QString("MODEL"));
     radarFormat = new QComboBox();
     radarFormatOpts = radarFormatOptions->keys();
@@ -856,8 +857,8 @@ CappiPanel::CappiPanel():AbstractPanel()
     interpolationMethod = new QHash<QString, QString>;
     interpolationMethod->insert(QString("Cressman Interpolation"),
                                 QString("cressman"));
-    //interpolationMethod->insert(QString("Barnes Interpolation"),
-    //			      QString("barnes"));
+    interpolationMethod->insert(QString("Barnes Interpolation"),
+                                QString("barnes"));
     //interpolationMethod->insert(QString("Closest Point Interpolation"),
     //QString("closestpoint"));
     //interpolationMethod->insert(QString("Bilinear Interpolation"),
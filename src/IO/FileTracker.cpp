@@ -0,0 +1,50 @@
+/*
+ * FileTracker.cpp
+ * VORTRAC
+ *
+ */
+
+#include <QFileInfo>
+
+#include "FileTracker.h"
+
+FileTracker::FileTracker(int settleSeconds)
+{
+    this->settleSeconds = settleSeconds;
+}
+
+bool FileTracker::isReady(const QString &filePath)
+{
+    QFileInfo info(filePath);
+    if (!info.exists()) {
+        pending.remove(filePath);
+        return false;
+    }
+
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    qint64 size = info.size();
+    QDateTime modified = info.lastModified().toUTC();
+
+    if (!pending.contains(filePath)) {
+        // First look, trust the modification time unless it is in the future
+        FileState state;
+        state.size = size;
+        state.modified = modified;
+        state.lastChange = (modified < now) ? modified : now;
+        pending.insert(filePath, state);
+    } else {
+        FileState &state = pending[filePath];
+        if ((state.size != size) || (state.modified != modified)) {
+            // Still being written
+            state.size = size;
+            state.modified = modified;
+            state.lastChange = now;
+        }
+    }
+
+    if (pending.value(filePath).lastChange.secsTo(now) >= settleSeconds) {
+        pending.remove(filePath);
+        return true;
+    }
+    return false;
+}
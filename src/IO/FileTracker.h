@@ -0,0 +1,43 @@
+/*
+ * FileTracker.h
+ * VORTRAC
+ *
+ * Tracks incoming data files until they have stopped growing, without
+ * blocking the caller. Each call to isReady() compares the file against
+ * what was seen on the previous poll.
+ *
+ */
+
+#ifndef FILETRACKER_H
+#define FILETRACKER_H
+
+#include <QString>
+#include <QDateTime>
+#include <QHash>
+
+class FileTracker
+{
+
+public:
+    FileTracker(int settleSeconds = 2);
+
+    // True once the file has kept the same size and modification time
+    // for settleSeconds. Files that have been quiet that long when first
+    // seen are ready straight away.
+    bool isReady(const QString &filePath);
+
+    // Files seen but not yet settled
+    bool hasPending() const { return !pending.isEmpty(); }
+
+private:
+    struct FileState {
+        qint64 size;
+        QDateTime modified;
+        QDateTime lastChange;
+    };
+
+    QHash<QString, FileState> pending;
+    int settleSeconds;
+};
+
+#endif
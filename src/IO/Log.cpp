@@ -13,8 +13,8 @@
 #include <QFileDialog>
 #include <QDateTime>
 
-Log::Log(QWidget *parent) 
-    : QWidget(parent)
+Log::Log(QObject *parent) 
+    : QObject(parent)
 {
     this->setObjectName("Log");
     connect(this, SIGNAL(log(const Message&)),
@@ -32,7 +32,8 @@ Log::Log(QWidget *parent)
     }
 
     logFileName = newName + ".log";
-    logFile = new QFile(workingDirectory.filePath(logFileName));
+    logWriter = new LogWriter(workingDirectory.filePath(logFileName));
+    logWriter->start();
 
     absoluteProgress = 0;
     //displayLocation = false;
@@ -43,7 +44,7 @@ Log::Log(QWidget *parent)
 
 Log::~Log()
 {
-    delete logFile;
+    delete logWriter;
     for(int i = StopLightQueue.count()-1; i >= 0; i--) {
         delete StopLightQueue[i];
     }
@@ -85,29 +86,20 @@ void Log::setWorkingDirectory(QDir& newDir)
     newFileName = newName+".log";
     newLogFile.setFileName(workingDirectory.filePath(newName+".log"));
 
-    usingFile.lock();
-    if(logFile->isOpen())
-        logFile->close();
-
-    if(!logFile->copy(newDir.filePath(newFileName))) {
-        emit log(Message(QString("SetWorkingDirectory: Could not copy "+logFile->fileName()+" to "+newDir.filePath(newFileName)+".  May not be logging errors"),0,this->objectName(),Yellow,QString("Could not move log file!")));
+    if(!logWriter->copy(newDir.filePath(newFileName))) {
+        emit log(Message(QString("SetWorkingDirectory: Could not copy "+logWriter->fileName()+" to "+newDir.filePath(newFileName)+".  May not be logging errors"),0,this->objectName(),Yellow,QString("Could not move log file!")));
         return;
     }
 
-    logFile->remove();
+    logWriter->remove();
     //Message::toScreen("log:beforeChange: "+workingDirectory.path());
     workingDirectory = newDir;
     //Message::toScreen("log:afterChange: "+workingDirectory.path());
     logFileName = newFileName;
 
-    QFile* oldLogFile = logFile;
-    delete oldLogFile;
-    logFile = new QFile(workingDirectory.filePath(logFileName));
-    logFile->setFileName(workingDirectory.filePath(logFileName));
-
-    emit log(Message(QString("Log location after working dir changed, log file = "+logFile->fileName()),0,this->objectName(),Green));
+    logWriter->setFileName(workingDirectory.filePath(logFileName));
 
-    usingFile.unlock();
+    emit log(Message(QString("Log location after working dir changed, log file = "+logWriter->fileName()),0,this->objectName(),Green));
 
 }
 
@@ -125,29 +117,22 @@ void Log::setLogFileName(QString& newName)
         QFile::remove(workingDirectory.filePath(newName));
     }
 
-    usingFile.lock();
-
-    if(!logFile->copy(workingDirectory.filePath(newName)))
-        //Message::toScreen("Log::setWorkingDirectory: could not copy "+logFile->fileName()+" to "+workingDirectory.filePath(newName));
+    if(!logWriter->copy(workingDirectory.filePath(newName)))
+        //Message::toScreen("Log::setWorkingDirectory: could not copy "+logWriter->fileName()+" to "+workingDirectory.filePath(newName));
         logFileName = newName;
-    logFile->setFileName(workingDirectory.filePath(logFileName));
-    //logFile = new QFile(workingDirectory.filePath(logFileName));
-    usingFile.unlock();
+    logWriter->setFileName(workingDirectory.filePath(logFileName));
 }
 
 bool Log::saveLogFile()
 {
-    QString saveName=QFileDialog::getSaveFileName(this, QString(tr("Save Status Log File as...")), workingDirectory.path(), QString(tr("Text Files *.txt")));
+    QString saveName=QFileDialog::getSaveFileName(NULL, QString(tr("Save Status Log File as...")), workingDirectory.path(), QString(tr("Text Files *.txt")));
 
     if(!saveName.isEmpty()) {
-        usingFile.lock();
-        if(logFile->copy(saveName)) {
-            usingFile.unlock();
+        if(logWriter->copy(saveName)) {
             return true;
         }
         else {
             Message::toScreen(tr("Failed to save log file"));
-            usingFile.unlock();
             return false;
         }
     }
@@ -173,26 +158,21 @@ bool Log::saveLogFile(const QString& fileName)
     if(QFile::exists(newFileName))
         QFile::remove(newFileName);
 
-    usingFile.lock();
     if(check.isAbsolute()) {
-        if(logFile->copy(fileName)) {
-            usingFile.unlock();
+        if(logWriter->copy(fileName)) {
             return true;
         }
         else {
             Message::toScreen(tr("Failed to save log file"));
-            usingFile.unlock();
             return false;
         }
     }
     else {
-        if(logFile->copy(workingDirectory.filePath(fileName))) {
-            usingFile.unlock();
+        if(logWriter->copy(workingDirectory.filePath(fileName))) {
             return true;
         }
         else {
             Message::toScreen(tr("Failed to save log file"));
-            usingFile.unlock();
             return false;
         }
     }
@@ -200,25 +180,23 @@ bool Log::saveLogFile(const QString& fileName)
 
 void Log::catchLog(const Message& logEntry)
 {
-    QMutex mutex;
-    mutex.lock();
-    Message* logg = new Message(logEntry);
-    QString message = logg->getLogMessage();
-    int progress = logg->getProgress();
-    QString location = logg->getLocation();
-    StopLightColor stopLightColor = logg->getColor();
-    QString stopLightMessage = logg->getStopLightMessage();
-    StormSignalStatus stormSignalStatus = logg->getStatus();
-    QString stormSignalMessage = logg->getStormSignalMessage();
+    Message logg(logEntry);
+    QString message = logg.getLogMessage();
+    int progress = logg.getProgress();
+    QString location = logg.getLocation();
+    StopLightColor stopLightColor = logg.getColor();
+    QString stopLightMessage = logg.getStopLightMessage();
+    StormSignalStatus stormSignalStatus = logg.getStatus();
+    QString stormSignalMessage = logg.getStormSignalMessage();
     bool debug = false;
     if(message!=QString()) {
         if(displayLocation && (location!=QString()) and debug) {
             message = location+": "+message;
         }
         message+="\n";
-        messagesWaiting.append(message);
         emit(newLogEntry(message));
-        writeToFile();
+        // Warnings and errors are written right away, the rest in batches
+        logWriter->append(message, (stopLightColor == Yellow) || (stopLightColor == Red));
     }
 
     if(progress!=0) {
@@ -248,37 +226,10 @@ void Log::catchLog(const Message& logEntry)
     }
 
     if (stopLightColor == Red) {
+        // The analysis is aborted, make sure the log has everything first
+        logWriter->flush();
         emit redLightAbort();
     }
-
-    delete logg;
-    mutex.unlock();
-}
-
-bool Log::writeToFile()
-{
-    if(usingFile.tryLock()) {
-        if(logFile->isOpen()) {
-            logFile->close();
-            //Message::toScreen("LOG: WRITETOFILE: LogFile "+logFile->fileName()+" was open and then I closed it");
-        }
-        //Message::toScreen("LOG: WRITETOFILE: Trying To Open "+logFile->fileName());
-        if(logFile->open(QIODevice::Append)) {
-            while((messagesWaiting.count() > 0)) {
-                logFile->write(messagesWaiting.first().toLatin1());
-                QString message = messagesWaiting.takeFirst();
-            }
-            logFile->close();
-            if(logFile->isOpen()) {
-                Message::toScreen("When logging messags logFile did not close but did not fail");
-                usingFile.unlock();
-                return false;
-            }
-        }
-        usingFile.unlock();
-        return true;
-    }
-    return false;
 }
 
 bool Log::handleStopLightUpdate(StopLightColor newColor, QString message, 
@@ -17,15 +17,15 @@
 #include <QFile>
 #include <QDomElement>
 #include <QDir>
-#include <QMutex>
 #include "IO/Message.h"
+#include "IO/LogWriter.h"
 
-class Log : public QWidget
+class Log : public QObject
 {
     Q_OBJECT
 
 public:
-    Log(QWidget *parent = 0);
+    Log(QObject *parent = 0);
     ~Log();
     bool saveLogFile();
     bool saveLogFile(const QString& fileName);
@@ -48,15 +48,10 @@ signals:
 
 private:
     QString logFileName;
-    QFile *logFile;
+    LogWriter *logWriter;
     QDir workingDirectory;
     int absoluteProgress;
     bool displayLocation;
-    QStringList messagesWaiting;
-    // bool usingFile;
-    QMutex usingFile;
-
-    bool writeToFile();
 
     struct SLChange {
         StopLightColor color;
@@ -0,0 +1,109 @@
+/*
+ * LogWriter.cpp
+ * VORTRAC
+ *
+ */
+
+#include "LogWriter.h"
+#include "Message.h"
+
+LogWriter::LogWriter(const QString &fileName, QObject *parent)
+    : QThread(parent)
+{
+    file.setFileName(fileName);
+    stopping = false;
+    flushInterval = 1000; // msec
+}
+
+LogWriter::~LogWriter()
+{
+    stop();
+}
+
+void LogWriter::append(const QString &line, bool urgent)
+{
+    QMutexLocker locker(&queueMutex);
+    queue.append(line);
+    if(urgent)
+        wake.wakeOne();
+}
+
+void LogWriter::run()
+{
+    queueMutex.lock();
+    while(!stopping) {
+        wake.wait(&queueMutex, flushInterval);
+        queueMutex.unlock();
+        writeQueued();
+        queueMutex.lock();
+    }
+    queueMutex.unlock();
+}
+
+void LogWriter::writeQueued()
+{
+    // The file is claimed first so that batches are written in order, then
+    // the whole queue is taken so that Log is not held up by the file
+    QMutexLocker locker(&fileMutex);
+    QStringList lines;
+    {
+        QMutexLocker queueLocker(&queueMutex);
+        lines.swap(queue);
+    }
+    if(lines.isEmpty())
+        return;
+    if(!file.isOpen() && !file.open(QIODevice::Append)) {
+        Message::toScreen("LogWriter: Could not open "+file.fileName());
+        return;
+    }
+    for(int i = 0; i < lines.count(); i++)
+        file.write(lines.at(i).toLatin1());
+    file.flush();
+}
+
+void LogWriter::flush()
+{
+    writeQueued();
+}
+
+void LogWriter::stop()
+{
+    {
+        QMutexLocker locker(&queueMutex);
+        stopping = true;
+        wake.wakeOne();
+    }
+    wait();
+    writeQueued();
+    QMutexLocker locker(&fileMutex);
+    file.close();
+}
+
+QString LogWriter::fileName()
+{
+    QMutexLocker locker(&fileMutex);
+    return file.fileName();
+}
+
+void LogWriter::setFileName(const QString &fileName)
+{
+    writeQueued();
+    QMutexLocker locker(&fileMutex);
+    file.close();
+    file.setFileName(fileName);
+}
+
+bool LogWriter::copy(const QString &newName)
+{
+    writeQueued();
+    QMutexLocker locker(&fileMutex);
+    file.close();
+    return QFile::copy(file.fileName(), newName);
+}
+
+bool LogWriter::remove()
+{
+    writeQueued();
+    QMutexLocker locker(&fileMutex);
+    return file.remove();
+}
@@ -0,0 +1,59 @@
+/*
+ * LogWriter.h
+ * VORTRAC
+ *
+ * Writes the status log from its own thread. Lines are queued by the Log
+ * and written to a file that stays open, in batches every flush interval
+ * or at once when an urgent line arrives.
+ *
+ */
+
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+
+class LogWriter : public QThread
+{
+
+public:
+    LogWriter(const QString &fileName, QObject *parent = 0);
+    ~LogWriter();
+
+    void append(const QString &line, bool urgent = false);
+
+    // Writes every queued line before returning
+    void flush();
+    void stop();
+
+    QString fileName();
+    // These flush and close the file first, it is reopened by the next write
+    void setFileName(const QString &fileName);
+    bool copy(const QString &newName);
+    bool remove();
+
+protected:
+    void run();
+
+private:
+    // Guards the queue and the stopping flag
+    QMutex queueMutex;
+    QWaitCondition wake;
+    QStringList queue;
+    bool stopping;
+    int flushInterval;
+
+    // Guards the file
+    QMutex fileMutex;
+    QFile file;
+
+    void writeQueued();
+
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * StageStats.cpp
+ * VORTRAC
+ *
+ */
+
+#include <sys/resource.h>
+#include <QAtomicPointer>
+
+#include "StageStats.h"
+
+static QAtomicPointer<StageStats> activeStats;
+// Several analyses can run in one process, each reports into its own
+// collector. Threads that never installed one, like the worker pools,
+// fall back to the last one installed.
+static thread_local StageStats *threadStats = NULL;
+
+StageStats::StageStats()
+{
+}
+
+void StageStats::clear()
+{
+    QMutexLocker locker(&mutex);
+    stages.clear();
+    nsecs.clear();
+    calls.clear();
+    counters.clear();
+    counts.clear();
+}
+
+void StageStats::addTime(const QString &stage, qint64 ns)
+{
+    QMutexLocker locker(&mutex);
+    if (!nsecs.contains(stage))
+        stages.append(stage);
+    nsecs[stage] += ns;
+    calls[stage] += 1;
+}
+
+void StageStats::addCount(const QString &counter, qint64 n)
+{
+    QMutexLocker locker(&mutex);
+    if (!counts.contains(counter))
+        counters.append(counter);
+    counts[counter] += n;
+}
+
+QStringList StageStats::getStages() const
+{
+    QMutexLocker locker(&mutex);
+    return stages;
+}
+
+double StageStats::getMilliseconds(const QString &stage) const
+{
+    QMutexLocker locker(&mutex);
+    return nsecs.value(stage, 0) / 1.0e6;
+}
+
+int StageStats::getCalls(const QString &stage) const
+{
+    QMutexLocker locker(&mutex);
+    return calls.value(stage, 0);
+}
+
+QStringList StageStats::getCounters() const
+{
+    QMutexLocker locker(&mutex);
+    return counters;
+}
+
+qint64 StageStats::getCount(const QString &counter) const
+{
+    QMutexLocker locker(&mutex);
+    return counts.value(counter, 0);
+}
+
+QJsonObject StageStats::toJson() const
+{
+    QMutexLocker locker(&mutex);
+    QJsonObject json;
+    for (int i = 0; i < stages.size(); i++) {
+        QJsonObject stage;
+        stage["ms"] = nsecs.value(stages.at(i)) / 1.0e6;
+        stage["calls"] = calls.value(stages.at(i));
+        json[stages.at(i)] = stage;
+    }
+    return json;
+}
+
+QJsonObject StageStats::countersToJson() const
+{
+    QMutexLocker locker(&mutex);
+    QJsonObject json;
+    for (int i = 0; i < counters.size(); i++)
+        json[counters.at(i)] = double(counts.value(counters.at(i)));
+    return json;
+}
+
+QString StageStats::toCsv(const QString &label) const
+{
+    QMutexLocker locker(&mutex);
+    QString csv;
+    for (int i = 0; i < stages.size(); i++)
+        csv += label + ", stage, " + stages.at(i) + ", "
+            + QString::number(nsecs.value(stages.at(i)) / 1.0e6, 'f', 3) + "\n";
+    for (int i = 0; i < counters.size(); i++)
+        csv += label + ", count, " + counters.at(i) + ", "
+            + QString::number(counts.value(counters.at(i))) + "\n";
+    return csv;
+}
+
+QString StageStats::summary() const
+{
+    QMutexLocker locker(&mutex);
+    QStringList parts;
+    for (int i = 0; i < stages.size(); i++)
+        parts << stages.at(i) + " " + QString::number(nsecs.value(stages.at(i)) / 1.0e6, 'f', 0) + " ms";
+    for (int i = 0; i < counters.size(); i++)
+        parts << counters.at(i) + " " + QString::number(counts.value(counters.at(i)));
+    return parts.join(", ");
+}
+
+void StageStats::count(const QString &counter, qint64 n)
+{
+    StageStats *stats = active();
+    if (stats)
+        stats->addCount(counter, n);
+}
+
+long StageStats::peakRss()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    // macOS reports bytes, Linux kB
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+StageStats* StageStats::active()
+{
+    if (threadStats)
+        return threadStats;
+    return activeStats.loadAcquire();
+}
+
+void StageStats::setActive(StageStats *stats)
+{
+    StageStats *previous = threadStats;
+    threadStats = stats;
+    if (stats)
+        activeStats.storeRelease(stats);
+    else
+        activeStats.testAndSetRelease(previous, NULL);
+}
+
+StageTimer::StageTimer(const QString &stage)
+{
+    this->stage = stage;
+    stats = StageStats::active();
+    if (stats)
+        timer.start();
+}
+
+StageTimer::~StageTimer()
+{
+    stop();
+}
+
+void StageTimer::stop()
+{
+    if (stats)
+        stats->addTime(stage, timer.nsecsElapsed());
+    stats = NULL;
+}
@@ -0,0 +1,87 @@
+/*
+ * StageStats.h
+ * VORTRAC
+ *
+ * Wall clock time spent in each processing stage of a volume, and counts
+ * of the work done there. The analysis driver installs one StageStats as
+ * the active collector and the stages report into it through StageTimer
+ * and StageStats::count().
+ *
+ */
+
+#ifndef STAGESTATS_H
+#define STAGESTATS_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+class StageStats
+{
+
+public:
+    StageStats();
+
+    void clear();
+    void addTime(const QString &stage, qint64 nsecs);
+    void addCount(const QString &counter, qint64 n);
+
+    // Stages in the order they were first reported
+    QStringList getStages() const;
+    double getMilliseconds(const QString &stage) const;
+    int getCalls(const QString &stage) const;
+    QStringList getCounters() const;
+    qint64 getCount(const QString &counter) const;
+
+    // {"stage": {"ms": ..., "calls": ...}, ...}
+    QJsonObject toJson() const;
+    // {"counter": n, ...}
+    QJsonObject countersToJson() const;
+
+    // One line per stage and counter, "label, stage|count, name, value"
+    QString toCsv(const QString &label) const;
+    // Short one line summary for the log
+    QString summary() const;
+
+    // Adds n to a counter of the active collector, if there is one
+    static void count(const QString &counter, qint64 n);
+
+    // Peak resident set size of the process in kB
+    static long peakRss();
+
+    // Collector the stages report into, NULL when nobody is listening.
+    // Installing one applies to the calling thread first.
+    static StageStats* active();
+    static void setActive(StageStats *stats);
+
+private:
+    mutable QMutex mutex;
+    QStringList stages;
+    QHash<QString, qint64> nsecs;
+    QHash<QString, int> calls;
+    QStringList counters;
+    QHash<QString, qint64> counts;
+};
+
+// Adds the time until it goes out of scope to a stage of the active
+// collector
+class StageTimer
+{
+
+public:
+    StageTimer(const QString &stage);
+    ~StageTimer();
+
+    // Report now rather than at the end of the scope
+    void stop();
+
+private:
+    QString stage;
+    StageStats *stats;
+    QElapsedTimer timer;
+};
+
+#endif
@@ -74,6 +74,18 @@ Hvvp::Hvvp()
 			xls[k][kk] = velNull;
 	}
 
+	layerCount = levels;
+	layerCoeff = new float*[levels];
+	layerStdErr = new float*[levels];
+	layerFitted = new bool[levels];
+	for(int i = 0; i < levels; i++) {
+		layerCoeff[i] = new float[xlsDimension];
+		layerStdErr[i] = new float[xlsDimension];
+		layerFitted[i] = false;
+	}
+	layersFitted = false;
+
+	volume = NULL;
 	printOutput = true;
 	hgtStart = .600;                // km   // Most Recently Used
 	//hgtStart = 1.0;
@@ -101,6 +113,14 @@ Hvvp::~Hvvp()
 	delete [] yls;
 	delete [] xls;
 	delete [] wgt;
+
+	for(int i = 0; i < layerCount; i++) {
+		delete [] layerCoeff[i];
+		delete [] layerStdErr[i];
+	}
+	delete [] layerCoeff;
+	delete [] layerStdErr;
+	delete [] layerFitted;
 }
 
 void Hvvp::setRadarData(RadarData *newVolume, float range, float angle, float vortexRmw)
@@ -313,6 +333,13 @@ long Hvvp::hvvpPrep(int m) {
 }
 
 bool Hvvp::findHVVPWinds(bool both)
+{
+	if(!fitLayers(both))
+		return false;
+	return combineLayers();
+}
+
+bool Hvvp::fitLayers(bool both)
 {
 	/*
 	* Calculates HVVP dependent and independent variables within 14, 200 m
@@ -349,7 +376,7 @@ bool Hvvp::findHVVPWinds(bool both)
 			emit log(Message(QString(),1,this->objectName()));
 		}
 
-		xt[m] = velNull; 
+		layerFitted[m] = false;
 
 		count = hvvpPrep(m);
 
@@ -363,8 +390,8 @@ bool Hvvp::findHVVPWinds(bool both)
 		if(count >= 6500.0) {
 
 			float sse;
-			float *stand_err = new float[xlsDimension];
-			float *cc = new float[xlsDimension];
+			float *stand_err = layerStdErr[m];
+			float *cc = layerCoeff[m];
 			bool flag, outlier;
       
 			// Only for comparisons in Mathematica
@@ -465,117 +492,148 @@ bool Hvvp::findHVVPWinds(bool both)
 						delete [] qcyls;
 					}
 				}
+				layerFitted[m] = true;
+			}
+		}
+		//Message::toScreen("HVVP Output From Level "+QString().setNum(m)+" count = "+QString().setNum(count));
 
-				// Calculate the HVVP wind parameters:
+	}
 
-				// Radial wind above the radar.
-				vr[m] = rt*cc[1];
+	layersFitted = true;
+	return true;
+}
 
-				// Along beam component of the environmental wind above the radar.
-				float vm_c = cc[3]+vr[m];
+bool Hvvp::recombine(float range, float angle, float vortexRmw)
+{
+	/*
+	* The layer fits only depend weakly on the center, so a nearby center
+	*   of the same volume reuses them and just redoes the wind parameters
+	*   and the layer average.
+	*/
 
-				// Rankine exponent of the radial wind.
-				xr[m] = -1.0*cc[4]/cc[1];
+	if(!layersFitted)
+		return false;
 
-				/* 
-				* Variance of xr.  This is used in the
-				*  weigthed average of the across beam component of the environmental wind,
-				*  c and is calculated along the way as follows:
-				*/
+	setRadarData(volume, range, angle, vortexRmw);
+	return combineLayers();
+}
 
-				float temp = ((stand_err[4]/cc[4])*(stand_err[4]/cc[4]));
-				temp += ((stand_err[1]/cc[1])*(stand_err[1]/cc[1]));
-				var[m] = fabs(xr[m])*sqrt(temp);
+bool Hvvp::combineLayers()
+{
+	rot = cca*deg2rad;
 
-				/*
-				* Relations between the Rankine exponent of the tangential wind, xt,
-				*   and xr, determined by theoretical (boundary layer) arguments of 
-				*   Willoughby (1995) for the case of inflow, and by extension
-				*   (constinuity equation considerations) by Harasti for the case
-				*   of outflow.
-				*/
+	for(int m = 0; m < levels; m++) {
 
-				if(vr[m] > 0) {
-					if(xr[m] > 0)
-						xt[m] = 1.0-xr[m];
-					else
-						xt[m] = -1.0*xr[m]/2.0;
-				}
-				else {
-					if(xr[m] >= 0)
-						xt[m] = xr[m]/2.0;
-					else
-						xt[m] = 1.+xr[m];
-				}
+		xt[m] = velNull;
 
-				if(fabs(xt[m]) == xr[m]/2.0) 
-					var[m] = .5*var[m];
+		if(!layerFitted[m]) {
+			//z[m] = h0;
+			u[m] = velNull;
+			v[m] = velNull;
+			vm_sin[m] = velNull;
+			var[m] = velNull;
+			continue;
+		}
 
-				// Tangential wind above the radar
-				// Assume error in rt is 2 km
+		float *stand_err = layerStdErr[m];
+		float *cc = layerCoeff[m];
 
-				vt[m] = rt*cc[6]/(xt[m]+1.0);
+		// Calculate the HVVP wind parameters:
 
+		// Radial wind above the radar.
+		vr[m] = rt*cc[1];
 
-				if(xt[m] == 0) {
-					emit log(Message(QString("Xt is Zero, Program Logic Problem"),0,this->objectName(),Red,QString("Xt = 0")));
-					return false;
-				}
+		// Along beam component of the environmental wind above the radar.
+		float vm_c = cc[3]+vr[m];
 
-				temp = (2./rt)*(2./rt)+(stand_err[6]/cc[6])*(stand_err[6]/cc[6]);
-				temp += (var[m]/xt[m])*(var[m]/xt[m]);
-				var[m] = vt[m]*sqrt(temp);
-
-				// Across-beam component of the environmental wind
-				float vm_s = cc[0]-vt[m];
-				//Message::toScreen(" vm_s = "+QString().setNum(vm_s));
-
-				var[m] = sqrt(stand_err[0]*stand_err[0] + var[m]*var[m]);
-
-				// rotate vm_c and vm_s to standard cartesian U and V components,
-				// ue and ve, using cca.
-				// cca  = cca *deg2rad;
-				// float ue = vm_s*cos(cca)+vm_c*sin(cca);
-				// float ve = vm_c*cos(cca)-vm_s*sin(cca);
-				//Message::toScreen("rot = "+QString().setNum(rot));
-
-				float ue = vm_s*cos(rot)+vm_c*sin(rot);
-				float ve = vm_c*cos(rot)-vm_s*sin(rot);
-				//Message::toScreen(" ve = "+QString().setNum(ve));
-				//Message::toScreen(" ue = "+QString().setNum(ue));
-				//Message::toScreen(" z[m] = "+QString().setNum(z[m]));
-
-				// Set realistic limit on magnitude of results.
-				if((xt[m] < 0)||(xt[m] > 1.5)||(fabs(ue)>30.0)||(fabs(ve)>30)||(vt[m]<1)) 
-				{
-					//z[m] = h0;               
-					u[m] = velNull;
-					v[m] = velNull;
-					vm_sin[m] = velNull;
-				} else {
-					//z[m] = hgtStart+hInc*float(m);
-					u[m] = ue;
-					v[m] = ve;
-					vm_sin[m] = vm_s;
-				}
-			} else {
-				//z[m] = h0;
-				u[m] = velNull;
-				v[m] = velNull;
-				vm_sin[m] = velNull;
-			}
-			delete [] stand_err;
-			delete [] cc;
-		} else {
-			//z[m] = h0;
+		// Rankine exponent of the radial wind.
+		xr[m] = -1.0*cc[4]/cc[1];
+
+		/* 
+		* Variance of xr.  This is used in the
+		*  weigthed average of the across beam component of the environmental wind,
+		*  c and is calculated along the way as follows:
+		*/
+
+		float temp = ((stand_err[4]/cc[4])*(stand_err[4]/cc[4]));
+		temp += ((stand_err[1]/cc[1])*(stand_err[1]/cc[1]));
+		var[m] = fabs(xr[m])*sqrt(temp);
+
+		/*
+		* Relations between the Rankine exponent of the tangential wind, xt,
+		*   and xr, determined by theoretical (boundary layer) arguments of 
+		*   Willoughby (1995) for the case of inflow, and by extension
+		*   (constinuity equation considerations) by Harasti for the case
+		*   of outflow.
+		*/
+
+		if(vr[m] > 0) {
+			if(xr[m] > 0)
+				xt[m] = 1.0-xr[m];
+			else
+				xt[m] = -1.0*xr[m]/2.0;
+		}
+		else {
+			if(xr[m] >= 0)
+				xt[m] = xr[m]/2.0;
+			else
+				xt[m] = 1.+xr[m];
+		}
+
+		if(fabs(xt[m]) == xr[m]/2.0) 
+			var[m] = .5*var[m];
+
+		// Tangential wind above the radar
+		// Assume error in rt is 2 km
+
+		vt[m] = rt*cc[6]/(xt[m]+1.0);
+
+
+		if(xt[m] == 0) {
+			emit log(Message(QString("Xt is Zero, Program Logic Problem"),0,this->objectName(),Red,QString("Xt = 0")));
+			return false;
+		}
+
+		temp = (2./rt)*(2./rt)+(stand_err[6]/cc[6])*(stand_err[6]/cc[6]);
+		temp += (var[m]/xt[m])*(var[m]/xt[m]);
+		var[m] = vt[m]*sqrt(temp);
+
+		// Across-beam component of the environmental wind
+		float vm_s = cc[0]-vt[m];
+		//Message::toScreen(" vm_s = "+QString().setNum(vm_s));
+
+		var[m] = sqrt(stand_err[0]*stand_err[0] + var[m]*var[m]);
+
+		// rotate vm_c and vm_s to standard cartesian U and V components,
+		// ue and ve, using cca.
+		// cca  = cca *deg2rad;
+		// float ue = vm_s*cos(cca)+vm_c*sin(cca);
+		// float ve = vm_c*cos(cca)-vm_s*sin(cca);
+		//Message::toScreen("rot = "+QString().setNum(rot));
+
+		float ue = vm_s*cos(rot)+vm_c*sin(rot);
+		float ve = vm_c*cos(rot)-vm_s*sin(rot);
+		//Message::toScreen(" ve = "+QString().setNum(ve));
+		//Message::toScreen(" ue = "+QString().setNum(ue));
+		//Message::toScreen(" z[m] = "+QString().setNum(z[m]));
+
+		// Set realistic limit on magnitude of results.
+		if((xt[m] < 0)||(xt[m] > 1.5)||(fabs(ue)>30.0)||(fabs(ve)>30)||(vt[m]<1)) 
+		{
+			//z[m] = h0;               
 			u[m] = velNull;
 			v[m] = velNull;
 			vm_sin[m] = velNull;
+		} else {
+			//z[m] = hgtStart+hInc*float(m);
+			u[m] = ue;
+			v[m] = ve;
+			vm_sin[m] = vm_s;
 		}
-		//Message::toScreen("HVVP Output From Level "+QString().setNum(m)+" z = "+QString().setNum(z[m])+" vm_sin = "+QString().setNum(vm_sin[m]));
-
 	}
 
+	long count = 0;
+
 	/*
 	*  Reject results whose Xt is greater than one SD from average Xt
 	*/
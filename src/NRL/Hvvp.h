@@ -30,6 +30,11 @@ public:
     void setConfig(Configuration* newConfig);
 
     bool findHVVPWinds(bool both);
+    bool fitLayers(bool both);
+    bool combineLayers();
+    bool recombine(float range, float angle, float vortexRmw);
+    bool hasLayerFits() const { return layersFitted; }
+    RadarData* getVolume() { return volume; }
 
     float* getHeights() { return z; }
     float* getUWinds() { return u; }
@@ -125,6 +130,19 @@ private:
     float *xt, *xr, *vt, *vr;
     bool printOutput;
 
+    float **layerCoeff, **layerStdErr;
+    bool *layerFitted;
+    bool layersFitted;
+    int layerCount;
+
+    /*
+    * layerCoeff, layerStdErr: The least squares coefficients and their
+    *              standard errors for each layer, kept so that the wind
+    *              parameters can be recombined for a nearby center
+    *              without refitting (see recombine).
+    *
+    */
+
     /*
     * printOutput: If this is set to true the HVVP output will be printed to
     *              the log file and message screen
@@ -19,6 +19,7 @@
 #include "Radar/RadarData.h"
 #include "IO/Message.h"
 #include "Math/Matrix.h"
+#include "IO/StageStats.h"
 
 RadarQC::RadarQC(RadarData *radarPtr, QObject *parent)
         :QObject(parent)
@@ -409,6 +410,12 @@ bool RadarQC::dealias()
   // reflectivity which could cause a large enough terminal velocity correction
   // to push clutter velocity beyond the assume +-1.5 m/s clutter threshold.
 
+  StageTimer timer("qc");
+  qint64 numGates = 0;
+  for (int n = 0; n < radarData->getNumRays(); n++)
+    numGates += radarData->getRay(n)->getVel_numgates();
+  StageStats::count("qc_gates", numGates);
+
   thresholdData();
   emit log(Message(QString(),1,this->objectName()));
 
@@ -13,7 +13,6 @@
 #include <iostream>
 #include <QPushButton>
 #include <math.h>
-#include <unistd.h>
 
 PressureFactory::PressureFactory(Configuration *mainCfg, QObject *parent) : QObject(parent)
 {
@@ -71,23 +70,15 @@ QList<PressureData>* PressureFactory::getUnprocessedData()
     // Get the files off the queue
     QString fileName = dataPath.filePath(pressureQueue->dequeue());
 
-    // Test file to make sure it is not growing
-    QFile pressureFile(fileName);
-    qint64 newFilesize = pressureFile.size();
-    qint64 prevFilesize = 0;
-    while (prevFilesize != newFilesize) {
-        prevFilesize = newFilesize;
-        sleep(1);
-        newFilesize = pressureFile.size();
-    }
-    sleep(1);
-
+    // Only settled files are queued, see hasUnprocessedData
 
     // Mark it as processed
     fileParsed[fileName] = true;
     
     // Now make a new pressureList from that file and send it back
     QList<PressureData>* pressureList = new QList<PressureData>;
+    // Station and time of every ob kept so far, to drop duplicates
+    QSet<PressureList::ObKey> obKeys;
     switch(pressureFormat) {
     case hwind :
     {
@@ -100,19 +91,14 @@ QList<PressureData>* PressureFactory::getUnprocessedData()
             QString ob = in.readLine();
             HWind *pressureData = new HWind(ob);
             // Check to make sure it is not a duplicate -- this messes up the XML structure
-            bool duplicateOb = false;
-            for (int i = 0; i < pressureList->size(); i++) {
-                if ((pressureList->at(i).getStationName() == pressureData->getStationName())
-                        and (pressureList->at(i).getTime() == pressureData->getTime())) {
-                    //emit log(Message("Omitting duplicate surface ob"));
-                    duplicateOb = true;
-                }
-            }
+            PressureList::ObKey obKey = PressureList::observationKey(*pressureData);
+            bool duplicateOb = obKeys.contains(obKey);
             // Check to make sure it is a near-surface measurement
             if ((pressureData->getAltitude() >= 0) and
                     (pressureData->getAltitude() <= 20) and
                     (!duplicateOb)) {
                 pressureList->append(*pressureData);
+                obKeys.insert(obKey);
             }
             delete pressureData;
         }
@@ -140,14 +126,8 @@ QList<PressureData>* PressureFactory::getUnprocessedData()
             //pressureData->setTime(obDateTime);
 
             // Check to make sure it is not a duplicate -- this messes up the XML structure
-            bool duplicateOb = false;
-            for (int i = 0; i < pressureList->size(); i++) {
-                if ((pressureList->at(i).getStationName() == pressureData->getStationName())
-                        and (pressureList->at(i).getTime() == pressureData->getTime())) {
-                    //emit log(Message("Omitting duplicate surface ob"));
-                    duplicateOb = true;
-                }
-            }
+            PressureList::ObKey obKey = PressureList::observationKey(*pressureData);
+            bool duplicateOb = obKeys.contains(obKey);
             // Check to make sure it is not a duplicate and not too far away
             float obLat = pressureData->getLat();
             float obLon = pressureData->getLon();
@@ -162,6 +142,7 @@ QList<PressureData>* PressureFactory::getUnprocessedData()
             float obRange = sqrt(relX*relX + relY*relY);
             if 	((!duplicateOb) and (obRange < 500)) {
                 pressureList->append(*pressureData);
+                obKeys.insert(obKey);
             }
             delete pressureData;
         }
@@ -190,14 +171,8 @@ QList<PressureData>* PressureFactory::getUnprocessedData()
                 //pressureData->setTime(obDateTime);
                 
                 // Check to make sure it is not a duplicate -- this messes up the XML structure
-                bool duplicateOb = false;
-                for (int i = 0; i < pressureList->size(); i++) {
-                    if ((pressureList->at(i).getStationName() == pressureData->getStationName())
-                        and (pressureList->at(i).getTime() == pressureData->getTime())) {
-                        //emit log(Message("Omitting duplicate surface ob"));
-                        duplicateOb = true;
-                    }
-                }
+                PressureList::ObKey obKey = PressureList::observationKey(*pressureData);
+                bool duplicateOb = obKeys.contains(obKey);
                 // Check to make sure it is not a duplicate and not too far away
                 float obLat = pressureData->getLat();
                 float obLon = pressureData->getLon();
@@ -215,6 +190,7 @@ QList<PressureData>* PressureFactory::getUnprocessedData()
                 if 	((!duplicateOb) and (obRange < 500) and (obAlt < 15.0)
                      and (obPressure < 1050.) and (obPressure > 850.)) {
                     pressureList->append(*pressureData);
+                    obKeys.insert(obKey);
                 }
                 delete pressureData;
             }
@@ -271,8 +247,9 @@ bool PressureFactory::hasUnprocessedData()
 
             if (fileDateTime >= startDateTime && fileDateTime <= endDateTime) {
                 // Valid time and pressure name, check to see if it has been processed
-                if (!fileParsed[dataPath.filePath(file)]) {
-                    // File has not been parsed, add it to the queue
+                if (!fileParsed[dataPath.filePath(file)]
+                        && fileTracker.isReady(dataPath.filePath(file))) {
+                    // File has not been parsed and is complete, add it to the queue
                     pressureQueue->enqueue(file);
                 }
             }
@@ -304,8 +281,9 @@ bool PressureFactory::hasUnprocessedData()
 
             if (fileDateTime >= startDateTime && fileDateTime <= endDateTime) {
                 // Valid time and pressure name, check to see if it has been processed
-                if (!fileParsed[dataPath.filePath(file)]) {
-                    // File has not been parsed, add it to the queue
+                if (!fileParsed[dataPath.filePath(file)]
+                        && fileTracker.isReady(dataPath.filePath(file))) {
+                    // File has not been parsed and is complete, add it to the queue
                     pressureQueue->enqueue(file);
                 }
             }
@@ -335,8 +313,9 @@ bool PressureFactory::hasUnprocessedData()
                 QDateTime fileDateTime = QDateTime(fileDate, fileTime, Qt::UTC);
                 if (fileDateTime >= startDateTime && fileDateTime <= endDateTime) {
                     // Valid time and pressure name, check to see if it has been processed
-                    if (!fileParsed[dataPath.filePath(file)]) {
-                        // File has not been parsed, add it to the queue
+                    if (!fileParsed[dataPath.filePath(file)]
+                            && fileTracker.isReady(dataPath.filePath(file))) {
+                        // File has not been parsed and is complete, add it to the queue
                         pressureQueue->enqueue(file);
                     }
                 }
@@ -23,6 +23,7 @@
 #include "Pressure/AWIPS.h"
 #include "Pressure/MADIS.h"
 #include "IO/Message.h"
+#include "IO/FileTracker.h"
 #include "GUI/ConfigTree.h"
 
 class PressureFactory : public QObject
@@ -56,6 +57,7 @@ private:
     QDateTime startDateTime;
     QDateTime endDateTime;
     QHash<QString, bool> fileParsed;
+    FileTracker fileTracker;
     float radarlat, radarlon;
 
 };
@@ -16,9 +16,13 @@
 #include <QString>
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 #include "PressureList.h"
 
+static const qint64 bucketSeconds = 3600;
+
 PressureList::PressureList(QString prsFilePath) : QList<PressureData>()
 {
     _filePath = prsFilePath;
@@ -81,3 +85,127 @@ bool PressureList::restore()
 {
     return false;
 }
+
+PressureList::ObKey PressureList::observationKey(const PressureData &ob)
+{
+    return ObKey(ob.getStationName(), ob.getTime().toMSecsSinceEpoch());
+}
+
+qint64 PressureList::timeBucket(const QDateTime &obTime)
+{
+    qint64 secs = obTime.toMSecsSinceEpoch() / 1000;
+    return (secs >= 0) ? secs / bucketSeconds : (secs - bucketSeconds + 1) / bucketSeconds;
+}
+
+// One degree longitude cell, from -180 to 179 whichever way the longitude
+// is written
+
+int PressureList::lonCellOf(float lon)
+{
+    int lonCell = int(floor(lon));
+    lonCell = ((lonCell + 180) % 360 + 360) % 360 - 180;
+    return lonCell;
+}
+
+int PressureList::cellKey(int latCell, int lonCell)
+{
+    return (latCell + 90) * 1024 + (lonCell + 360);
+}
+
+void PressureList::indexObservation(int i)
+{
+    const PressureData &ob = at(i);
+    int latCell = int(floor(ob.getLat()));
+    _index[timeBucket(ob.getTime())][cellKey(latCell, lonCellOf(ob.getLon()))].append(i);
+    _keys.insert(observationKey(ob));
+}
+
+void PressureList::rebuildIndex()
+{
+    _index.clear();
+    _keys.clear();
+    for (int i = 0; i < size(); i++)
+        indexObservation(i);
+}
+
+void PressureList::append(const PressureData &ob)
+{
+    QList<PressureData>::append(ob);
+    indexObservation(size() - 1);
+}
+
+void PressureList::replace(int i, const PressureData &ob)
+{
+    QList<PressureData>::replace(i, ob);
+    rebuildIndex();
+}
+
+void PressureList::removeAt(int i)
+{
+    // Every later index shifts down
+    QList<PressureData>::removeAt(i);
+    rebuildIndex();
+}
+
+void PressureList::clear()
+{
+    QList<PressureData>::clear();
+    _index.clear();
+    _keys.clear();
+}
+
+bool PressureList::addObservation(const PressureData &ob)
+{
+    if (_keys.contains(observationKey(ob)))
+        return false;
+    append(ob);
+    return true;
+}
+
+QList<int> PressureList::findObservations(const QDateTime &obTime, int maxTimeDiff,
+                                          float lat, float lon, float maxRadius) const
+{
+    QList<int> found;
+    if (maxTimeDiff <= 0)
+        return found;
+
+    // Degrees spanned by maxRadius, padded so the box never clips the circle
+    float latRadians = lat * acos(-1.0) / 180.0;
+    float latReach = maxRadius / 110.0 + 0.01;
+    float cosLat = cos(latRadians);
+    float lonReach = (cosLat > 0.01) ? maxRadius / (110.0 * cosLat) + 0.01 : 360;
+    int latLow = int(floor(lat - latReach));
+    int latHigh = int(floor(lat + latReach));
+    int lonLow = int(floor(lon - lonReach));
+    int lonHigh = int(floor(lon + lonReach));
+    if (latLow < -90) latLow = -90;
+    if (latHigh > 90) latHigh = 90;
+    // Cells past the dateline are wrapped around when looked up, so only
+    // the span matters
+    if (lonHigh - lonLow >= 360) {
+        lonLow = -180;
+        lonHigh = 179;
+    }
+
+    QDateTime earliest = obTime.addSecs(-maxTimeDiff);
+    QMap<qint64, QHash<int, QVector<int> > >::const_iterator bucket = _index.lowerBound(timeBucket(earliest));
+    QMap<qint64, QHash<int, QVector<int> > >::const_iterator lastBucket = _index.upperBound(timeBucket(obTime));
+    for (; bucket != lastBucket; ++bucket) {
+        const QHash<int, QVector<int> > &cells = bucket.value();
+        for (int latCell = latLow; latCell <= latHigh; latCell++) {
+            for (int lonCell = lonLow; lonCell <= lonHigh; lonCell++) {
+                QHash<int, QVector<int> >::const_iterator cell = cells.constFind(cellKey(latCell, lonCellOf(lonCell)));
+                if (cell == cells.constEnd())
+                    continue;
+                const QVector<int> &obs = cell.value();
+                for (int n = 0; n < obs.size(); n++) {
+                    int obTimeDiff = at(obs[n]).getTime().secsTo(obTime);
+                    if ((obTimeDiff > 0) && (obTimeDiff <= maxTimeDiff))
+                        found.append(obs[n]);
+                }
+            }
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
@@ -14,6 +14,11 @@
 
 #include <QList>
 #include <QString>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QSet>
+#include <QVector>
 
 #include "Pressure/PressureData.h"
 
@@ -21,14 +26,46 @@ class PressureList : public QList<PressureData>
 {
 
 public:
+    // Observations are unique by station and time
+    typedef QPair<QString, qint64> ObKey;
+    static ObKey observationKey(const PressureData &ob);
+
     PressureList(QString prsFilePath=QString());
     virtual ~PressureList();
     bool saveXML();
     bool restore();
     void setFilePath(QString prsFilePath);
+
+    // Appends the observation unless one from the same station and time is
+    // already in the list, returns true if it was added
+    bool addObservation(const PressureData &ob);
+
+    // The list changes only through these, which keep the index up to date.
+    // Observations can be read but not edited in place.
+    void append(const PressureData &ob);
+    void replace(int i, const PressureData &ob);
+    void removeAt(int i);
+    void clear();
+    const PressureData &operator[](int i) const { return at(i); }
+
+    // Indices (ascending) of the observations that are 0 < dt <= maxTimeDiff
+    // seconds before obTime and inside the lat/lon box that holds maxRadius
+    // km around (lat, lon). Callers still apply the exact distance test.
+    QList<int> findObservations(const QDateTime &obTime, int maxTimeDiff,
+                                float lat, float lon, float maxRadius) const;
+
 private:
     QString _filePath;
     void createDomPressureDataEntry(const PressureData &newData);
+
+    // Observations bucketed by hour and by one degree lat/lon cell
+    QMap<qint64, QHash<int, QVector<int> > > _index;
+    QSet<ObKey> _keys;
+    void indexObservation(int i);
+    void rebuildIndex();
+    static qint64 timeBucket(const QDateTime &obTime);
+    static int lonCellOf(float lon);
+    static int cellKey(int latCell, int lonCell);
 };
 
 #endif
@@ -12,6 +12,7 @@
 #define RADARDATA_H
 
 #include <QString>
+#include <QStringList>
 #include <QFile>
 #include <QDateTime>
 #include <QDomElement>
@@ -45,6 +46,11 @@ public:
     bool writeToFile(const QString fileName);
     bool fileIsReadable();
     QString getFileName();
+    // Every file that makes up the volume, just the one for most formats
+    virtual QStringList getFileNames() { return QStringList(radarFileName); }
+    // More files of a volume that is still streaming in. The next
+    // readVolume() reads just these and keeps what it had.
+    virtual bool addFiles(const QStringList &) { return false; }
     float getMaxUnambig_range();
     void setMaxRange(float f) { maxRange = f; }
     void setPreGridded() { preGridded = true; }
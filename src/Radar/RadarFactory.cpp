@@ -10,7 +10,6 @@
 
 #include <iostream>
 #include <QPushButton>
-#include <unistd.h>
 
 #include "RadarFactory.h"
 #include "DateChecker.h"
@@ -42,6 +41,17 @@ RadarFactory::RadarFactory(Configuration* radarConfig, QObject *parent): QObject
     QString path = mainConfig->getParam(radar,"dir");
     dataPath = QDir(path);
 
+    // Research volumes can be split over many sweep files. When a span
+    // (in seconds) is given, the files that start within it of the first
+    // one are read together as a single volume.
+    volumeSpan = mainConfig->getParam(radar,"volumespan").toInt();
+
+    // In real time the low sweeps of a volume are usually all the cappi
+    // needs, and they are in minutes before the top of the volume. With
+    // streamsweeps the analysis starts on the sweeps that are there.
+    streamSweeps = mainConfig->getParam(radar,"streamsweeps") == "true";
+    streamingVolume = false;
+
     QString format = mainConfig->getParam(radar,"format");
     if (format == "LDMLEVELII") {
         radarFormat = ldmlevelII;
@@ -51,10 +61,18 @@ RadarFactory::RadarFactory(Configuration* radarConfig, QObject *parent): QObject
         radarFormat = model;
     } else if (format == "NETCDF") {
         radarFormat = netcdf;
+    } else if (format == "DORADE") {
+        radarFormat = dorade;
     } else {
         // Will implement more later but give error for now
         emit log(Message("Data format not supported"));
     }
+
+    // Gridded files are always whole volumes
+    if (radarFormat == netcdf)
+        volumeSpan = 0;
+    if (volumeSpan <= 0)
+        streamSweeps = false;
 }
 
 RadarFactory::~RadarFactory()
@@ -75,21 +93,35 @@ RadarData* RadarFactory::getUnprocessedData()
     }
 
     // Get the files off the queue
-    QString fileName = dataPath.filePath(radarQueue->dequeue());
-
-    // Test file to make sure it is not growing
-    QFile radarFile(fileName);
-    qint64 newFilesize = radarFile.size();
-    qint64 prevFilesize = 0;
-    while (prevFilesize != newFilesize) {
-        prevFilesize = newFilesize;
-        sleep(1);
-        newFilesize = radarFile.size();
+    QString file = radarQueue->dequeue();
+    QString fileName = dataPath.filePath(file);
+
+    // The files of the volume still coming in go to it, see
+    // updateStreamedVolume
+    streamingVolume = (file == openVolume);
+    if (streamingVolume) {
+      streamStart = openStart;
+      openVolume.clear();
     }
-    sleep(1);
+
+    // Only settled files are queued, see hasUnprocessedData
     // Mark it as processed
     fileAnalyzed[fileName] = true;
 
+    // The rest of the volume, if it was split over several files
+    QStringList volumeFiles;
+    if (volumeMembers.contains(file)) {
+      QStringList members = volumeMembers.take(file);
+      for (int i = 0; i < members.size(); i++) {
+        volumeFiles << dataPath.filePath(members.at(i));
+        fileAnalyzed[volumeFiles.last()] = true;
+      }
+    }
+    if (streamingVolume) {
+      streamFiles.clear();
+      streamFiles << fileName << volumeFiles;
+    }
+
     // Now make a new radar object from that file and send it back
     switch(radarFormat) {
 
@@ -97,7 +129,11 @@ RadarData* RadarFactory::getUnprocessedData()
     case model:
     case ncdclevelII:
     case dorade: {
-      RadxData *radarData = new RadxData(radarName, radarLat, radarLon, fileName);
+      RadxData *radarData;
+      if (volumeFiles.size() > 1)
+        radarData = new RadxData(radarName, radarLat, radarLon, volumeFiles);
+      else
+        radarData = new RadxData(radarName, radarLat, radarLon, fileName);
       radarData->setAltitude(radarAlt);
       return radarData;
     }
@@ -162,6 +198,10 @@ bool RadarFactory::hasUnprocessedData()
 
     DateChecker *checker = DateCheckerFactory::newChecker(radarFormat);
 
+    QStringList volume;
+    QDateTime volumeStart;
+    bool volumeComplete = true;
+
     for (int i = 0; i < filenames.size(); i++) {
       QString file = filenames.at(i);
 
@@ -169,8 +209,51 @@ bool RadarFactory::hasUnprocessedData()
 	continue;
 
       // Get the date info from the file name
-      if(checker->fileInRange(file, radarName, startDateTime, endDateTime))
-	radarQueue->enqueue(file);
+      if(!checker->fileInRange(file, radarName, startDateTime, endDateTime))
+	continue;
+
+      // Late files of a volume that was streamed were not needed
+      if (streamStart.isValid()
+	  && (streamStart.secsTo(checker->getTime()) >= 0)
+	  && (streamStart.secsTo(checker->getTime()) <= volumeSpan)) {
+	fileAnalyzed[dataPath.filePath(file)] = true;
+	continue;
+      }
+
+      if (volumeSpan <= 0) {
+	// One file per volume. Leave files that are still being written
+	// for a later poll
+	if (fileTracker.isReady(dataPath.filePath(file)))
+	  radarQueue->enqueue(file);
+	continue;
+      }
+
+      // A file still being written holds back its volume and everything
+      // after it until a later poll
+      if (!fileTracker.isReady(dataPath.filePath(file))) {
+	volumeComplete = false;
+	break;
+      }
+
+      QDateTime fileTime = checker->getTime();
+      if (!volume.isEmpty() && (volumeStart.secsTo(fileTime) > volumeSpan)) {
+	enqueueVolume(volume);
+	volume.clear();
+      }
+      if (volume.isEmpty())
+	volumeStart = fileTime;
+      volume << file;
+    }
+
+    // Without a later file the last volume is done once its span is over
+    if (!volume.isEmpty() && volumeComplete
+	&& (volumeStart.secsTo(QDateTime::currentDateTimeUtc()) > volumeSpan)) {
+      enqueueVolume(volume);
+    } else if (!volume.isEmpty() && streamSweeps && (volumeStart != retryStart)) {
+      // Hand it out with what has arrived
+      enqueueVolume(volume);
+      openVolume = volume.first();
+      openStart = volumeStart;
     }
 
     delete checker;
@@ -367,6 +450,78 @@ bool RadarFactory::hasUnprocessedData()
 
 }
 
+void RadarFactory::enqueueVolume(const QStringList& files)
+{
+    // The first file stands for the volume in the queue
+    radarQueue->enqueue(files.first());
+    if (files.size() > 1)
+        volumeMembers[files.first()] = files;
+}
+
+// Picks up the files of the streamed volume that have settled since the
+// last call. Returns false once no more can come, when a later volume has
+// started or the span is over.
+
+bool RadarFactory::updateStreamedVolume(QStringList &newFiles)
+{
+    if (!streamingVolume)
+      return false;
+
+    dataPath.setFilter(QDir::Files);
+    dataPath.setSorting(QDir::Name);
+    QStringList filenames = dataPath.entryList();
+
+    DateChecker *checker = DateCheckerFactory::newChecker(radarFormat);
+    bool writing = false;
+    bool later = false;
+
+    for (int i = 0; i < filenames.size(); i++) {
+      QString filePath = dataPath.filePath(filenames.at(i));
+      if (fileAnalyzed[filePath] || streamFiles.contains(filePath))
+	continue;
+      if(!checker->fileInRange(filenames.at(i), radarName, startDateTime, endDateTime))
+	continue;
+      int offset = streamStart.secsTo(checker->getTime());
+      if (offset < 0)
+	continue;
+      if (offset > volumeSpan) {
+	later = true;
+	break;
+      }
+      if (fileTracker.isReady(filePath)) {
+	newFiles << filePath;
+	streamFiles << filePath;
+      } else {
+	writing = true;
+      }
+    }
+    delete checker;
+
+    // A file still being written comes in on a later call
+    bool open = writing || (!later
+			    && (streamStart.secsTo(QDateTime::currentDateTimeUtc()) <= volumeSpan));
+
+    if (!open)
+      streamingVolume = false;
+    return open;
+}
+
+// The files of the streamed volume count as processed once it has been
+// read. When that failed, they are left for a later poll, which groups
+// them as a normal volume once it is over.
+
+void RadarFactory::finishStreamedVolume(bool read)
+{
+    streamingVolume = false;
+    for (int i = 0; i < streamFiles.size(); i++)
+      fileAnalyzed[streamFiles.at(i)] = read;
+    if (!read) {
+      retryStart = streamStart;
+      streamStart = QDateTime();
+    }
+    streamFiles.clear();
+}
+
 void RadarFactory::catchLog(const Message& message)
 {
     emit log (message);
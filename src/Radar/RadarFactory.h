@@ -25,6 +25,7 @@
 #include "Radar/AnalyticRadar.h"
 #include "Radar/RadxData.h"
 #include "IO/Message.h"
+#include "IO/FileTracker.h"
 #include "GUI/ConfigTree.h"
 #include "DataObjects/VortexList.h"
 
@@ -40,6 +41,11 @@ public:
     RadarData* getUnprocessedData();
     bool hasUnprocessedData();
     int getNumProcessed() const;
+    bool hasPendingData() const { return fileTracker.hasPending(); }
+    // True when the last volume handed out was still coming in
+    bool isStreaming() const { return streamingVolume; }
+    bool updateStreamedVolume(QStringList &newFiles);
+    void finishStreamedVolume(bool read);
 
     enum dataFormat {
       ncdclevelII,
@@ -70,8 +76,25 @@ private:
     QDateTime startDateTime;
     QDateTime endDateTime;
     QHash<QString, bool> fileAnalyzed;
+    // Files making up each queued volume, keyed by its first file
+    QHash<QString, QStringList> volumeMembers;
+    int volumeSpan;
+    // With streamsweeps, the volume that is still coming in is handed out
+    // with the files it has so far, the rest follows through
+    // updateStreamedVolume()
+    bool streamSweeps;
+    bool streamingVolume;
+    QString openVolume;
+    QDateTime openStart;
+    QDateTime streamStart;
+    // Files handed to the streamed volume, processed once it is read
+    QStringList streamFiles;
+    // A streamed volume that failed is retried whole, once it is over
+    QDateTime retryStart;
+    FileTracker fileTracker;
     QDateTime radarDateTime;
     Configuration* mainConfig;
+    void enqueueVolume(const QStringList& files);
 };
 
 #endif
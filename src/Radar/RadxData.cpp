@@ -11,7 +11,42 @@
 #include "Radx/RadxSweep.hh"
 #include "Radx/RadxRay.hh"
 
+#include <QThreadPool>
+#include <QMutex>
+#include <QFile>
+
 #include "RadxData.h"
+#include "IO/StageStats.h"
+#include "Threads/VolumeScheduler.h"
+
+// The NetCDF and HDF5 libraries under the CfRadial reader are not safe to
+// enter from several threads, so those files are read one at a time.
+// Everything else, and the field conversion, runs in parallel.
+static QMutex netcdfMutex;
+
+// What the fields we grid are called. NEXRAD and CfRadial first, then
+// the names in DORADE sweep files.
+static const char *const refNames[] = { "REF", "DZ", "DBZ", NULL };
+static const char *const velNames[] = { "VEL", "VR", "VE", NULL };
+static const char *const swNames[]  = { "SW", NULL };
+
+static bool isNetcdfFile(const QString &fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+  QByteArray magic = file.read(4);
+  return magic.startsWith("CDF") || magic.startsWith("\x89HDF");
+}
+
+void RadxFileTask::run()
+{
+  if (_fill)
+    _data->fillRays(_file);
+  else
+    _data->fileRead[_file] = _data->readFile(_data->volumeFiles.at(_file),
+					     *_data->fileVols[_file]);
+}
 
 RadxData::RadxData(const QString &radarname, const float &lat, const float &lon, const QString &filename)
   : RadarData(radarname, lat, lon, filename)
@@ -20,7 +55,17 @@ RadxData::RadxData(const QString &radarname, const float &lat, const float &lon,
   numRays = 0;
   radarLat = lat;
   radarLon = lon;
+  volumeFiles << filename;
+}
 
+RadxData::RadxData(const QString &radarname, const float &lat, const float &lon, const QStringList &filenames)
+  : RadarData(radarname, lat, lon, filenames.first())
+{
+  numSweeps = 0;
+  numRays = 0;
+  radarLat = lat;
+  radarLon = lon;
+  volumeFiles = filenames;
 }
 
 RadxData::~RadxData()
@@ -29,14 +74,14 @@ RadxData::~RadxData()
   delete [] Rays;
   Sweeps = NULL;
   Rays = NULL;
+  for (size_t i = 0; i < fileVols.size(); i++)
+    delete fileVols[i];
 }
 
-// TODO
-// This essentially takes an array of float from the Radx library,
-// and shoves it into an array of float in the Radar object.
-// See if we can change the RadarData interface to access the
-// Radx data directly
-// Maybe put a handle to the field instead of the arrays
+// Hands back the Radx fl32 gates of a field in place, with the missing
+// value switched to -999. The whole volume was converted to fl32 when it
+// was read, so this is a single pass over the ray and nothing is copied.
+// The gates stay owned by the RadxVol, which lives as long as we do.
 
 float *RadxData::getRayData(RadxRay *fileRay, const char *fieldName)
 {
@@ -45,41 +90,41 @@ float *RadxData::getRayData(RadxRay *fileRay, const char *fieldName)
   if (field == NULL)
     return NULL;
 
-  float *retVal = new float[field->getNPoints()];
-  if (retVal == NULL) {
-    std::cerr << "RadxData::fillRayData: Failed to allocate data array" << std::endl;
-    return NULL;
-  }
-
-  // Convert field to float32
-  field->convertToFl32();
-  
   // When homebrew picks up the fixed version,
   // uncomment the next line, and remove the check
   // for missingFl32.
   // field->setMissingFl32(-999.0);
 
-  const float missing32 = field->getMissingFl32();
+  const Radx::fl32 missing32 = field->getMissingFl32();
 
-  const Radx::fl32 *fieldPtr = field->getDataFl32();
-  for(size_t index = 0; index < field->getNPoints(); index++) {
-    float val = fieldPtr[index];
-    if (val == missing32)
-      val = -999.0;
-    retVal[index] = val;
+  Radx::fl32 *fieldPtr = (Radx::fl32 *) field->getDataFl32();
+  if (fieldPtr == NULL)
+    return NULL;
+  const size_t nPoints = field->getNPoints();
+  if (missing32 != -999.0) {
+    for(size_t index = 0; index < nPoints; index++)
+      fieldPtr[index] = (fieldPtr[index] == missing32) ? -999.0f : fieldPtr[index];
   }
-  return retVal;
+  return fieldPtr;
 }
 
-bool RadxData::readVolume()
+// The first of the names the ray has
+
+float *RadxData::getRayData(RadxRay *fileRay, const char *const *fieldNames)
+{
+  for (int n = 0; fieldNames[n] != NULL; n++) {
+    if (fileRay->getField(fieldNames[n]) != NULL)
+      return getRayData(fileRay, fieldNames[n]);
+  }
+  return NULL;
+}
+
+bool RadxData::readFile(const QString &fileName, RadxVol &vol)
 {
   // Read in a file using the Radx interface.
   // The file can be in any format supported by the Radx library.
 
   RadxFile file;
-  RadxVol vol;
-
-  QString fileName = getFileName();
 
   if ( ! file.isSupported(fileName.toLatin1().data()) ) {
     std::cerr << "ERROR - File '" << fileName.toLatin1().data()
@@ -89,27 +134,139 @@ bool RadxData::readVolume()
 
   file.setReadPreserveSweeps(true); // prevent Radx from tossing away long sweeps
 
-  if (file.readFromPath(fileName.toLatin1().data(), vol) ) {
+  // Only the fields we grid, everything else would just be decoded,
+  // converted and carried along for nothing. DORADE sweep files carry
+  // a dozen or more parameters, most of which we never look at.
+  for (int n = 0; refNames[n] != NULL; n++)
+    file.addReadField(refNames[n]);
+  for (int n = 0; velNames[n] != NULL; n++)
+    file.addReadField(velNames[n]);
+  for (int n = 0; swNames[n] != NULL; n++)
+    file.addReadField(swNames[n]);
+
+  bool netcdf = isNetcdfFile(fileName);
+  if (netcdf)
+    netcdfMutex.lock();
+  int status = file.readFromPath(fileName.toLatin1().data(), vol);
+  if (netcdf)
+    netcdfMutex.unlock();
+
+  if (status) {
     std::cerr << "ERROR - reading file: " << fileName.toLatin1().data() << std::endl;
     std::cerr << file.getErrStr() << std::endl;
     return false;
   }
 
-  numSweeps = vol.getNSweeps();
-  numRays = vol.getNRays();
+  // Convert every field to float32 in one go, the rays then point
+  // straight at these gates
+  vol.convertToFl32();
+  return true;
+}
 
-  int scanID = vol.getScanId();  // VCP
+bool RadxData::addFiles(const QStringList &filenames)
+{
+  volumeFiles << filenames;
+  return true;
+}
 
-  // Allocate storage for sweeps and rays
+bool RadxData::readVolume()
+{
+  // While a volume streams in, this is called again as its files arrive.
+  // Files read on an earlier call are kept, only the new ones are read.
+  int numFiles = volumeFiles.size();
+  int firstNew = fileVols.size();
+  fileVols.resize(numFiles, NULL);
+  fileRead.resize(numFiles, false);
+  for (int f = firstNew; f < numFiles; f++)
+    fileVols[f] = new RadxVol;
+
+  // Read all the new files at once. A single file is read right here,
+  // there is nothing to overlap it with.
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(VolumeScheduler::threadBudget());
+  if (numFiles - firstNew == 1) {
+    RadxFileTask(this, firstNew, false).run();
+  } else {
+    for (int f = firstNew; f < numFiles; f++)
+      pool.start(new RadxFileTask(this, f, false));
+    pool.waitForDone();
+  }
 
+  // Lay the files end to end in the merged volume. A bad sweep file is
+  // left out rather than losing the whole volume.
+
+  rayOffset.assign(numFiles, 0);
+  sweepOffset.assign(numFiles, 0);
+  numRays = 0;
+  numSweeps = 0;
+  for (int f = 0; f < numFiles; f++) {
+    rayOffset[f] = numRays;
+    sweepOffset[f] = numSweeps;
+    if (!fileRead[f])
+      continue;
+    numRays += fileVols[f]->getNRays();
+    numSweeps += fileVols[f]->getNSweeps();
+  }
+  if (numRays == 0)
+    return false;
+  if (numFiles > 1)
+    StageStats::count("volume_files", numFiles - firstNew);
+
+  // Allocate storage for sweeps and rays, over the ones of the last call
+
+  delete [] Sweeps;
+  delete [] Rays;
   Sweeps = new Sweep[numSweeps];
   Rays = new Ray[numRays];
 
+  // Convert the rays of each file straight into their slot in the merged
+  // volume, then fill in the sweeps (which need info from the rays)
+
+  if (numFiles == 1) {
+    fillRays(0);
+  } else {
+    for (int f = 0; f < numFiles; f++)
+      if (fileRead[f])
+	pool.start(new RadxFileTask(this, f, true));
+    pool.waitForDone();
+  }
+
+  for (int f = 0; f < numFiles; f++) {
+    if (fileRead[f])
+      fillSweeps(f);
+  }
+
+  // Apparently, Radx gives me a certain number of sweeps, but some of them are missing.
+  // These are the long range sweeps that do not contain dopler velocity.
+  // So adjust how many sweeps we really have
+
+  int lastFile = numFiles - 1;
+  while (!fileRead[lastFile])
+    lastFile--;
+  numSweeps = sweepOffset[lastFile] + fileVols[lastFile]->getSweeps().size();
+
+  // Set the volume date to the date of the first ray
+
+  radarDateTime.setTimeSpec(Qt::UTC);
+  RadxTime rtime((time_t) Rays[0].getDate());
+  radarDateTime.setDate(QDate(rtime.getYear(), rtime.getMonth(), rtime.getDay()));
+  radarDateTime.setTime(QTime(rtime.getHour(), rtime.getMin(), rtime.getSec()));
+
+  return true;
+}
+
+void RadxData::fillRays(int file)
+{
+  RadxVol &vol = *fileVols[file];
+
+  int scanID = vol.getScanId();  // VCP
+
   // Iterate on the rays (since they have info we need for the sweep)
 
   const vector<RadxRay *> rays = vol.getRays();
   vector<RadxRay *>::const_iterator ray_it;
-  int rayCount = 0;
+  int rayCount = rayOffset[file];
 
   for(ray_it = rays.begin(); ray_it < rays.end(); ray_it++, rayCount++) {
     RadxRay *fileRay = *ray_it;
@@ -157,9 +314,9 @@ bool RadxData::readVolume()
     // With file.setReadPreserveSweeps(true) above (to match what the old reader was doing),
     //    we might have long rays that don't have VEL and SW
 
-    myRay->setRefData(getRayData(fileRay, "REF"));
-    myRay->setVelData(getRayData(fileRay, "VEL"));
-    myRay->setSwData( getRayData(fileRay, "SW"));
+    myRay->shareRefData(getRayData(fileRay, refNames));
+    myRay->shareVelData(getRayData(fileRay, velNames));
+    myRay->shareSwData( getRayData(fileRay, swNames));
 
     // Lots of algorithms (QC Cappi, can't deal with missing Vel)
     // So fill in the Velocity data with -999)
@@ -170,13 +327,22 @@ bool RadxData::readVolume()
 	buffer[i] = -999;
       myRay->setVelData(buffer);
     }
+
+    // No reflectivity under any of its names, don't let anyone walk the gates
+    if(myRay->getRefData() == NULL)
+      myRay->setRef_numgates(0);
   }
+}
+
+void RadxData::fillSweeps(int file)
+{
+  RadxVol &vol = *fileVols[file];
 
   // Iterate on the sweeps
 
   const vector<RadxSweep *>  sweeps = vol.getSweeps();
   vector<RadxSweep *>::const_iterator sweep_it;
-  int sweepCount = 0;
+  int sweepCount = sweepOffset[file];
 
   for (sweep_it = sweeps.begin(); sweep_it < sweeps.end(); sweep_it++, sweepCount++) {
     RadxSweep *file_sweep = *sweep_it;
@@ -188,12 +354,13 @@ bool RadxData::readVolume()
 
     Sweep *my_sweep = &Sweeps[sweepCount];
 
-    int firstRayIndex = file_sweep->getStartRayIndex();
+    int firstRayIndex = rayOffset[file] + file_sweep->getStartRayIndex();
+    int lastRayIndex = rayOffset[file] + file_sweep->getEndRayIndex();
     Ray *firstRay = &Rays[firstRayIndex];
 
     my_sweep->setSweepIndex(sweepCount);
     my_sweep->setFirstRay(firstRayIndex);
-    my_sweep->setLastRay(file_sweep->getEndRayIndex());
+    my_sweep->setLastRay(lastRayIndex);
 
     // Set the sweep index for all the rays in this sweep.
     // Also sump up the gates from all the rays in this sweep. TODO Is this correct???
@@ -205,7 +372,7 @@ bool RadxData::readVolume()
     // I don't have access to these values, but it looks like 1..n for each sweep
 
     int rayIndex = 1;
-    for(size_t rayCount = firstRayIndex; rayCount <= file_sweep->getEndRayIndex();
+    for(int rayCount = firstRayIndex; rayCount <= lastRayIndex;
 	rayCount++, rayIndex++) {
       Rays[rayCount].setSweepIndex(sweepCount);
       Rays[rayCount].setRayIndex(rayIndex);
@@ -226,19 +393,4 @@ bool RadxData::readVolume()
     my_sweep->setNyquist_vel(firstRay->getNyquist_vel());
     my_sweep->setVcp(firstRay->getVcp());
   }
-
-  // Apparently, Radx gives me a certain number of sweeps, but some of them are missing.
-  // These are the long range sweeps that do not contain dopler velocity.
-  // So adjust how many sweeps we really have
-
-  numSweeps = sweepCount;
-
-  // Set the volume date to the date of the first ray
-
-  radarDateTime.setTimeSpec(Qt::UTC);
-  RadxTime rtime((time_t) Rays[0].getDate());
-  radarDateTime.setDate(QDate(rtime.getYear(), rtime.getMonth(), rtime.getDay()));
-  radarDateTime.setTime(QTime(rtime.getHour(), rtime.getMin(), rtime.getSec()));
-
-  return true;
 }
@@ -1,20 +1,65 @@
 #ifndef RADXDATA_H
 #define RADXDATA_H
 
+#include <QStringList>
+#include <QRunnable>
+#include <vector>
+
 #include "Radx/RadxRay.hh"
+#include "Radx/RadxVol.hh"
 #include "Radar/RadarData.h"
 
+class RadxData;
+
+// Reads one file of a volume into its own RadxVol, or converts the rays of
+// an already read file into their slice of the merged volume. Each task only
+// touches its own RadxVol and rays, so all the files of a volume can be
+// handled at once.
+class RadxFileTask : public QRunnable
+{
+ public:
+  RadxFileTask(RadxData* data, int file, bool fill)
+    : _data(data), _file(file), _fill(fill) {}
+  void run();
+
+ private:
+  RadxData* _data;
+  int _file;
+  bool _fill;
+};
+
 class RadxData : public RadarData
 {
+  friend class RadxFileTask;
+
  public:
   
   RadxData(const QString &radarname, const float &lat, const float &lon,
 	 const QString &filename);
+  // A volume made up of several sweep or CfRadial files, in time order
+  RadxData(const QString &radarname, const float &lat, const float &lon,
+	 const QStringList &filenames);
   ~RadxData();
 
   bool readVolume();
+  QStringList getFileNames() { return volumeFiles; }
+  bool addFiles(const QStringList &filenames);
   float *getRayData(RadxRay *fileRay, const char *fieldName);
-  
+  float *getRayData(RadxRay *fileRay, const char *const *fieldNames);
+
+ private:
+
+  bool readFile(const QString &fileName, RadxVol &vol);
+  void fillRays(int file);
+  void fillSweeps(int file);
+
+  QStringList volumeFiles;
+  std::vector<RadxVol*> fileVols;
+  // Not vector<bool>, the read tasks set their own entries at once
+  std::vector<char> fileRead;
+  // Where each file's rays and sweeps start in the merged volume
+  std::vector<int> rayOffset;
+  std::vector<int> sweepOffset;
 };
 
 #endif
@@ -23,6 +23,7 @@ Ray::Ray()
   refData = NULL;
   velData = NULL;
   swData = NULL;
+  ownRef = ownVel = ownSw = true;
   unambig_range = -999;
   nyquist_vel = -999;
   first_ref_gate = -999;
@@ -36,9 +37,9 @@ Ray::Ray()
 
 Ray::~Ray()
 {
-  if (refData != NULL) delete [] refData;
-  if (velData != NULL) delete [] velData;
-  if (swData != NULL) delete [] swData;
+  if ((refData != NULL) && ownRef) delete [] refData;
+  if ((velData != NULL) && ownVel) delete [] velData;
+  if ((swData != NULL) && ownSw) delete [] swData;
 }
 
 void Ray::setTime(const time_t &value) {
@@ -73,14 +74,17 @@ void Ray::setSweepIndex(const int &value) {
 
 void Ray::allocateRefData(const short int numGates) {
   refData = new float[numGates];
+  ownRef = true;
 }
 
 void Ray::allocateVelData(const short int numGates) {
   velData = new float[numGates];
+  ownVel = true;
 }
 
 void Ray::allocateSwData(const short int numGates) {
   swData = new float[numGates];
+  ownSw = true;
 }
 
 void Ray::setUnambig_range(const float &value) {
@@ -46,9 +46,15 @@ class Ray
   void setVcp(const int &value);
   void emptyRefgates(const short int numGates);
 
-  void setRefData(float *buffer) { refData = buffer; };
-  void setVelData(float *buffer) { velData = buffer; };
-  void setSwData(float *buffer)  { swData = buffer; };
+  void setRefData(float *buffer) { refData = buffer; ownRef = true; };
+  void setVelData(float *buffer) { velData = buffer; ownVel = true; };
+  void setSwData(float *buffer)  { swData = buffer; ownSw = true; };
+
+  // Point at gates that belong to someone else (e.g. the Radx volume
+  // they were read into). The ray will not free them.
+  void shareRefData(float *buffer) { refData = buffer; ownRef = false; };
+  void shareVelData(float *buffer) { velData = buffer; ownVel = false; };
+  void shareSwData(float *buffer)  { swData = buffer; ownSw = false; };
   
   time_t getTime();
   time_t getDate();
@@ -86,6 +92,9 @@ class Ray
   float *refData;
   float *velData;
   float *swData;
+  bool ownRef;
+  bool ownVel;
+  bool ownSw;
   float unambig_range;
   float nyquist_vel;
   int first_ref_gate;
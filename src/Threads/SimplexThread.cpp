@@ -10,12 +10,14 @@
 
 #include <QtGui>
 #include <math.h>
+#include <utility>
 #include "SimplexThread.h"
 #include "DataObjects/Coefficient.h"
 #include "DataObjects/Center.h"
 #include "VTD/VTDFactory.h"
 #include "Math/Matrix.h"
 #include "NRL/Hvvp.h"
+#include "IO/StageStats.h"
 
 // TODO debug
 # include <iostream>
@@ -29,6 +31,7 @@ SimplexThread::SimplexThread(QObject* parent):QObject(parent)
 
     _dataGaps = NULL;
     _vtdCoeffs = NULL;
+    _simplexVTD = NULL;
 }
 
 SimplexThread::~SimplexThread()
@@ -55,20 +58,23 @@ void SimplexThread::initParam(Configuration *wholeConfig,GriddedData *dataPtr,fl
 bool SimplexThread::findCenter(SimplexList* simplexList)
 {
 
+    StageTimer timer("simplex");
+
     //STEP 1: retrieve all the parameters for Simplex algorithm
 
-    QDomElement simplexCfg = configData->getConfig("center");
-    QString geometry = configData->getParam(simplexCfg,QString("geometry"));
-    QString velField = configData->getParam(simplexCfg,QString("velocity"));
-    QString closure = configData->getParam(simplexCfg,QString("closure"));
+    RingParams simplexCfg = configData->getCenterParams();
+    QString geometry = simplexCfg.geometry;
+    QString velField = simplexCfg.velocity;
+    QString closure = simplexCfg.closure;
+    _velHandle = gridData->getFieldIndex(velField);
 
-    firstLevel= configData->getParam(simplexCfg,QString("bottomlevel")).toFloat();
-    lastLevel = configData->getParam(simplexCfg,QString("toplevel")).toFloat();
-    firstRing = configData->getParam(simplexCfg,QString("innerradius")).toFloat();
-    lastRing  = configData->getParam(simplexCfg,QString("outerradius")).toFloat();
+    firstLevel= simplexCfg.bottomLevel;
+    lastLevel = simplexCfg.topLevel;
+    firstRing = simplexCfg.innerRadius;
+    lastRing  = simplexCfg.outerRadius;
 
-    float boxSize = configData->getParam(simplexCfg,QString("boxdiameter")).toFloat();
-    float numPoints = configData->getParam(simplexCfg,QString("numpoints")).toFloat();
+    float boxSize = simplexCfg.boxDiameter;
+    float numPoints = simplexCfg.numPoints;
 
     if(numPoints >= 25) {
       std::cerr << "*** Error: <numpoints> is greater than 25 "
@@ -79,18 +85,17 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
     float boxRowLength = sqrt(numPoints);
     float boxIncr = boxSize / (sqrt(numPoints) - 1);
 
-    float radiusOfInfluence = configData->getParam(simplexCfg,QString("influenceradius")).toFloat();
-    float convergeCriterion = configData->getParam(simplexCfg,QString("convergence")).toFloat();
-    float maxIterations = configData->getParam(simplexCfg,QString("maxiterations")).toFloat();
-    float ringWidth = configData->getParam(simplexCfg,QString("ringwidth")).toFloat();
-    int   maxWave = configData->getParam(simplexCfg,QString("maxwavenumber")).toInt();
+    float radiusOfInfluence = simplexCfg.influenceRadius;
+    float convergeCriterion = simplexCfg.convergence;
+    float maxIterations = simplexCfg.maxIterations;
+    float ringWidth = simplexCfg.ringWidth;
+    int   maxWave = simplexCfg.maxWaveNumber;
 
     // Define the maximum allowable data gaps
 
     _dataGaps = new float[maxWave+1];
     for (int i = 0; i <= maxWave; i++) {
-        _dataGaps[i] = configData->getParam(simplexCfg, QString("maxdatagap"), QString("wavenum"),
-					    QString().setNum(i)).toFloat();
+        _dataGaps[i] = simplexCfg.maxDataGap.value(i);
     }
 
     //SETP 2: initialize a VTD object for whole simplex to use
@@ -124,6 +129,20 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
     vertex[2] = new float[2];
     float* VT = new float[3];
     float* vertexSum = new float[2];
+    float initialX[75], initialY[75], initialVT[75];
+    bool refine[25];
+
+    // In coarse mode the initial simplexes act as a coarse lattice of the
+    // symmetric wind, and only the best starting points are refined
+    bool coarseSearch = (simplexCfg.searchMode == "coarse");
+    int numSurvivors = simplexCfg.survivors;
+    if (numSurvivors <= 0)
+        numSurvivors = int(numPoints) / 4;
+    // Keep enough of them for the spread of the converged centers to mean
+    // something
+    numSurvivors = qMax(3, numSurvivors);
+    if (coarseSearch && (numSurvivors < numPoints))
+        simplexData->setNumPointsRefined(numSurvivors);
 
     // Loop through the levels and rings,
     // TODO Should this have some reference to grid spacing?
@@ -135,6 +154,7 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
         for (float radius = firstRing; radius <= lastRing; radius++) {
 
             gridData->setAbsoluteReferencePoint(_latGuess, _lonGuess, height);
+            _setRing(radius, height);
             // Set the corner of the box
             float CornerI = gridData->getCartesianRefPointI();
             float CornerJ = gridData->getCartesianRefPointJ();
@@ -160,9 +180,11 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
             stdDevVertex = stdDevVT = 0;
             convergingCenters = 0;
 
-            // Loop through the initial guesses
+            // Lay out the initial simplex of every starting point and get
+            // the mean wind at all of the vertices in one batch
 	    // std::cout << "** Num of points: " << numPoints << std::endl;
 
+            float sqr32 = 0.866025;
             for (int point = 0; point < numPoints; point++) {
                 if (point < boxRowLength)
                     RefI = CornerI + float(point) * boxIncr;
@@ -174,21 +196,46 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
                 startX[point] = RefI;
                 startY[point] = RefJ;
 
-                // Initialize vertices
-                float sqr32 = 0.866025;
-                vertex[0][0] = RefI;
-                vertex[0][1] = RefJ + radiusOfInfluence;
-                vertex[1][0] = RefI + sqr32 * radiusOfInfluence;
-                vertex[1][1] = RefJ - 0.5 * radiusOfInfluence;
-                vertex[2][0] = RefI - sqr32 * radiusOfInfluence;
-                vertex[2][1] = RefJ - 0.5 * radiusOfInfluence;
-                vertexSum[0] = 0;
-                vertexSum[1] = 0;
+                initialX[3*point]   = RefI;
+                initialY[3*point]   = RefJ + radiusOfInfluence;
+                initialX[3*point+1] = RefI + sqr32 * radiusOfInfluence;
+                initialY[3*point+1] = RefJ - 0.5 * radiusOfInfluence;
+                initialX[3*point+2] = RefI - sqr32 * radiusOfInfluence;
+                initialY[3*point+2] = RefJ - 0.5 * radiusOfInfluence;
+            }
+            _getSymWinds(3*int(numPoints), initialX, initialY, radius, height, velField, initialVT);
+
+            for (int point = 0; point < numPoints; point++)
+                refine[point] = true;
+            if (coarseSearch && (numSurvivors < numPoints)) {
+                float score[25];
+                for (int point = 0; point < numPoints; point++)
+                    score[point] = qMax(initialVT[3*point], qMax(initialVT[3*point+1], initialVT[3*point+2]));
+                for (int point = 0; point < numPoints; point++) {
+                    int rank = 0;
+                    for (int other = 0; other < numPoints; other++) {
+                        if ((score[other] > score[point]) || ((score[other] == score[point]) && (other < point)))
+                            rank++;
+                    }
+                    refine[point] = (score[point] > 0) && (rank < numSurvivors);
+                }
+            }
 
+            for (int point = 0; point < numPoints; point++) {
+                if (!refine[point]) {
+                    endX[point]  = Center::_fillv;
+                    endY[point]  = Center::_fillv;
+                    VTind[point] = Center::_fillv;
+                    continue;
+                }
+                // Initialize vertices
                 for (int v = 0; v <= 2; v++) {
-		  //Calculate mean wind at each vertex
-		  VT[v] = _getSymWind(vertex[v][0], vertex[v][1], int(RefK), radius, height, velField);
+                    vertex[v][0] = initialX[3*point+v];
+                    vertex[v][1] = initialY[3*point+v];
+                    VT[v] = initialVT[3*point+v];
                 }
+                vertexSum[0] = 0;
+                vertexSum[1] = 0;
 
                 // Run the simplex search loop
                 float VTsolution = .0, Xsolution = 0. , Ysolution=0.;
@@ -230,8 +277,12 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
                         stdDevVTAll += (VTind[i] - meanVTall) * (VTind[i] - meanVTall);
                     }
                 }
-                stdDevVertexAll = sqrt(stdDevVertexAll/float(meanCount - 1));
-                stdDevVTAll = sqrt(stdDevVTAll/float(meanCount - 1));
+                // A single center has no spread to filter on
+                int solutions = meanCount;
+                if (solutions > 1) {
+                    stdDevVertexAll = sqrt(stdDevVertexAll/float(meanCount - 1));
+                    stdDevVTAll = sqrt(stdDevVTAll/float(meanCount - 1));
+                }
 
                 // Now remove centers beyond 1 standard deviation
                 meanCount = 0;
@@ -239,7 +290,7 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
                     if ((endX[i] != -999.) and (endY[i] != -999.) and (VTind[i] != -999.)) {
                         float vertexDist = sqrt((endX[i] - meanXall) * (endX[i] - meanXall)
 						+ (endY[i] - meanYall) * (endY[i] - meanYall));
-                        if (vertexDist < stdDevVertexAll) {
+                        if ((solutions < 2) || (vertexDist < stdDevVertexAll)) {
                             Xconv[meanCount] = endX[i];
                             Yconv[meanCount] = endY[i];
                             VTconv[meanCount] = VTind[i];
@@ -263,8 +314,10 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
                         stdDevVertex += ((Xconv[i] - meanX) * (Xconv[i] - meanX)+ (Yconv[i] - meanY) * (Yconv[i] - meanY));
                         stdDevVT += (VTconv[i] - meanVT) * (VTconv[i] - meanVT);
                     }
-                    stdDevVertex = sqrt(stdDevVertex / float(meanCount - 1));
-                    stdDevVT = sqrt(stdDevVT / float(meanCount - 1));
+                    if (meanCount > 1) {
+                        stdDevVertex = sqrt(stdDevVertex / float(meanCount - 1));
+                        stdDevVT = sqrt(stdDevVT / float(meanCount - 1));
+                    }
 
                     // All done with this radius and height, archive it
                     archiveCenters(simplexData, radius, height, numPoints);
@@ -273,7 +326,8 @@ bool SimplexThread::findCenter(SimplexList* simplexList)
         } //ring loop end
     } //height loop end
 
-    simplexList->append(*simplexData);
+    // Hand the results over to the list rather than copying them
+    simplexList->append(std::move(*simplexData));
     delete simplexData;
     // Deallocate memory for the vertices
     delete[] vertex[0];
@@ -364,17 +418,15 @@ float SimplexThread::_simplexTest(float**& vertex,float*& VT,float*& vertexSum,
         vertexTest[i] = vertexSum[i]*factor1 - vertex[low][i]*factor2;
 
     // Get the data
-    gridData->setCartesianReferencePoint(int(vertexTest[0]),int(vertexTest[1]),int(RefK));
-    int numData = gridData->getCylindricalAzimuthLength(radius, height);
-    float* ringData = new float[numData];
-    float* ringAzimuths = new float[numData];
-    gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-    gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
+    int numData = gridData->getCylindricalAzimuthData(_velHandle, _ring, int(vertexTest[0]), int(vertexTest[1]),
+                                                      _ringData.data(), _ringAzimuths.data());
+    float* ringData = _ringData.data();
+    float* ringAzimuths = _ringAzimuths.data();
 
     // Call vtd
     if (_simplexVTD->analyzeRing(vertexTest[0], vertexTest[1], radius, height, numData,
 				 ringData,ringAzimuths, _vtdCoeffs, vtdStdDev)) {
-        if (_vtdCoeffs[0].getParameter() == "VTC0") {
+        if (_vtdCoeffs[0].getParameterId() == Coefficient::VTC0) {
             VTtest = _vtdCoeffs[0].getValue();
         } else {
             emit log(Message("Error retrieving VTC0 in simplex!"));
@@ -384,9 +436,6 @@ float SimplexThread::_simplexTest(float**& vertex,float*& VT,float*& vertexSum,
         // emit log(Message("Not enough data in simplex ring"));
     }
 
-    delete[] ringData;
-    delete[] ringAzimuths;
-
     // If its a better point than the worst, replace it
     if (VTtest > VT[low]) {
         VT[low] = VTtest;
@@ -402,35 +451,48 @@ float SimplexThread::_simplexTest(float**& vertex,float*& VT,float*& vertexSum,
 
 float SimplexThread::_getSymWind(float vertex_x,float vertex_y,int RefK,float radius,float height,QString velField)
 {
+    // The ring table already fixes the level, so RefK is not needed
+    Q_UNUSED(RefK);
     float VT=-999.0f;
-    gridData->setCartesianReferencePoint(int(vertex_x),int(vertex_y),RefK);
-    int numData = gridData->getCylindricalAzimuthLength(radius, height);    // TODO
-    float* ringData = new float[numData];
-    float* ringAzimuths = new float[numData];
-    gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-    // azimuth data should look like sine wave
-    gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
-#if 0
-    // TODO debug
-    for(int d = 0; d < numData; d++) {
-      std::cout <<  "d: " << d << " val: " << ringData[d]
-		<< " azimuth: " << ringAzimuths[d] << std::endl;
-    }
-#endif
-    Coefficient*  vtdCoeffs=new Coefficient[20];
-    float   vtdStdDev;
+    _getSymWinds(1, &vertex_x, &vertex_y, radius, height, velField, &VT);
+    return VT;
+}
 
-    // vtCoeff[0..numCoeffs].value will be set by this call
+void SimplexThread::_setRing(float radius, float height)
+{
+    // Build the ring offsets once per level and radius and size the
+    // buffers for the largest ring any vertex can extract
+    gridData->getCylindricalAzimuthRing(radius, height, _ring);
+    _ringData.resize(_ring.k.size());
+    _ringAzimuths.resize(_ring.k.size());
+}
 
-    if (_simplexVTD->analyzeRing(vertex_x, vertex_y, radius, height, numData, ringData, ringAzimuths, vtdCoeffs, vtdStdDev)) {
-        if (vtdCoeffs[0].getParameter() == "VTC0")
-            VT = vtdCoeffs[0].getValue();
+void SimplexThread::_getSymWinds(int numVertices, const float* vertex_x, const float* vertex_y,
+                                 float radius, float height, const QString& velField, float* VT)
+{
+    // Mean tangential wind for a batch of candidate centers on the current ring
+    float* ringData = _ringData.data();
+    float* ringAzimuths = _ringAzimuths.data();
+    float stdDev;
+    for (int v = 0; v < numVertices; v++) {
+        VT[v] = -999.0f;
+        float x = vertex_x[v];
+        float y = vertex_y[v];
+        int numData = gridData->getCylindricalAzimuthData(_velHandle, _ring, int(x), int(y),
+                                                          ringData, ringAzimuths);
+#if 0
+        // TODO debug
+        for(int d = 0; d < numData; d++) {
+          std::cout <<  "d: " << d << " val: " << ringData[d]
+		    << " azimuth: " << ringAzimuths[d] << std::endl;
+        }
+#endif
+        // vtCoeff[0..numCoeffs].value will be set by this call
+        if (_simplexVTD->analyzeRing(x, y, radius, height, numData, ringData, ringAzimuths, _vtdCoeffs, stdDev)) {
+            if (_vtdCoeffs[0].getParameterId() == Coefficient::VTC0)
+                VT[v] = _vtdCoeffs[0].getValue();
+        }
     }
-
-    delete[] ringData;
-    delete[] ringAzimuths;
-    delete[] vtdCoeffs;
-    return VT;
 }
 
 void SimplexThread::_centerIterate(float** vertex, float* vertexSum, float* VT, int maxIterations, float convergeCriterion,
@@ -495,4 +557,5 @@ void SimplexThread::_centerIterate(float** vertex, float* vertexSum, float* VT,
         else
             --numIterations;
     }
+    StageStats::count("simplex_iterations", numIterations);
 }
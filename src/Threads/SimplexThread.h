@@ -65,6 +65,12 @@ private:
     float Xconv[25],Yconv[25],VTconv[25];
     float startX[25], startY[25];
 
+    // Ring table for the current level and radius, shared by all vertices
+    CylindricalRing _ring;
+    GriddedData::FieldHandle _velHandle;
+    QVector<float> _ringData;
+    QVector<float> _ringAzimuths;
+
 
     void archiveCenters(SimplexData* simplexData,float radius,float height,float numPoints);
     void archiveNull(SimplexData* simplexData,float& radius,float& height,float& numPoints);
@@ -76,6 +82,9 @@ private:
     // Choosecenter variables
     float velNull;
     float _getSymWind(float vertex_x,float vertex_y,int RefK,float radius,float height,QString velField);
+    void  _getSymWinds(int numVertices, const float* vertex_x, const float* vertex_y,
+                       float radius, float height, const QString& velField, float* VT);
+    void  _setRing(float radius, float height);
     void  _centerIterate(float** vertex,float* vertexSum, float* VT,int maxIterations,float convergeCriterion,
                           float RefK,float radius,float height,QString velField,float& VTsolution,float& Xsolution,float& Ysolution);
 };
@@ -0,0 +1,118 @@
+/*
+ * VolumeScheduler.cpp
+ * VORTRAC
+ *
+ */
+
+#include <QAtomicPointer>
+#include <QThread>
+
+#include "VolumeScheduler.h"
+
+static QAtomicPointer<VolumeScheduler> activeScheduler;
+
+VolumeScheduler::VolumeScheduler(int slots, Policy policy)
+{
+    if (slots < 1)
+        slots = 1;
+    this->slots = slots;
+    this->policy = policy;
+    freeSlots = slots;
+    nextTicket = 0;
+}
+
+VolumeScheduler::Policy VolumeScheduler::policyFromString(const QString &name, bool *ok)
+{
+    if (ok)
+        *ok = true;
+    if (name == "newest")
+        return newestFirst;
+    if (name == "priority")
+        return stormPriority;
+    if (ok)
+        *ok = false;
+    return newestFirst;
+}
+
+bool VolumeScheduler::goesBefore(const Request &a, const Request &b) const
+{
+    if (policy == stormPriority) {
+        if (a.priority != b.priority)
+            return a.priority > b.priority;
+        if (a.time != b.time)
+            return a.time > b.time;
+    } else {
+        if (a.time != b.time)
+            return a.time > b.time;
+        if (a.priority != b.priority)
+            return a.priority > b.priority;
+    }
+    // Otherwise first come, first served
+    return a.ticket < b.ticket;
+}
+
+void VolumeScheduler::acquire(const QDateTime &volumeTime, int priority)
+{
+    QMutexLocker locker(&mutex);
+    Request request;
+    request.time = volumeTime;
+    request.priority = priority;
+    request.ticket = nextTicket++;
+    waiting.append(request);
+
+    forever {
+        if (freeSlots > 0) {
+            // Only go if no other waiting volume should go first
+            int best = 0;
+            for (int i = 1; i < waiting.size(); i++) {
+                if (goesBefore(waiting.at(i), waiting.at(best)))
+                    best = i;
+            }
+            if (waiting.at(best).ticket == request.ticket) {
+                waiting.removeAt(best);
+                freeSlots--;
+                return;
+            }
+        }
+        slotFree.wait(&mutex);
+    }
+}
+
+void VolumeScheduler::release()
+{
+    QMutexLocker locker(&mutex);
+    freeSlots++;
+    slotFree.wakeAll();
+}
+
+int VolumeScheduler::threadBudget()
+{
+    int threads = QThread::idealThreadCount();
+    VolumeScheduler *scheduler = active();
+    if (scheduler)
+        threads /= scheduler->getSlots();
+    return (threads < 1) ? 1 : threads;
+}
+
+VolumeScheduler* VolumeScheduler::active()
+{
+    return activeScheduler.loadAcquire();
+}
+
+void VolumeScheduler::setActive(VolumeScheduler *scheduler)
+{
+    activeScheduler.storeRelease(scheduler);
+}
+
+VolumeSlot::VolumeSlot(const QDateTime &volumeTime, int priority)
+{
+    scheduler = VolumeScheduler::active();
+    if (scheduler)
+        scheduler->acquire(volumeTime, priority);
+}
+
+VolumeSlot::~VolumeSlot()
+{
+    if (scheduler)
+        scheduler->release();
+}
@@ -0,0 +1,78 @@
+/*
+ * VolumeScheduler.h
+ * VORTRAC
+ *
+ * Decides which storm analyses a volume next when several storms run in
+ * one process. Each storm still works through its own volumes in order,
+ * the scheduler only bounds how many volumes are gridded and analysed at
+ * once and picks who goes next when a slot frees up. The parallel stages
+ * size their thread pools from it, so the storms share the cores instead
+ * of each assuming it has the whole machine.
+ *
+ */
+
+#ifndef VOLUMESCHEDULER_H
+#define VOLUMESCHEDULER_H
+
+#include <QString>
+#include <QDateTime>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+
+class VolumeScheduler
+{
+
+public:
+    enum Policy {
+        newestFirst,     // the most recent volume of any storm
+        stormPriority    // the storm with the highest <vortex><priority>
+    };
+
+    VolumeScheduler(int slots, Policy policy);
+
+    // Blocks until the volume may go ahead, pair with release()
+    void acquire(const QDateTime &volumeTime, int priority);
+    void release();
+
+    int getSlots() const { return slots; }
+    static Policy policyFromString(const QString &name, bool *ok = 0);
+
+    // Threads each parallel stage may use, all of them when nothing is
+    // scheduled
+    static int threadBudget();
+
+    // Scheduler the analyses report to, NULL outside multi-storm runs
+    static VolumeScheduler* active();
+    static void setActive(VolumeScheduler *scheduler);
+
+private:
+    struct Request {
+        QDateTime time;
+        int priority;
+        quint64 ticket;
+    };
+    bool goesBefore(const Request &a, const Request &b) const;
+
+    int slots;
+    int freeSlots;
+    Policy policy;
+    quint64 nextTicket;
+    QList<Request> waiting;
+    QMutex mutex;
+    QWaitCondition slotFree;
+};
+
+// Holds a slot of the active scheduler until it goes out of scope
+class VolumeSlot
+{
+
+public:
+    VolumeSlot(const QDateTime &volumeTime, int priority);
+    ~VolumeSlot();
+
+private:
+    VolumeScheduler *scheduler;
+};
+
+#endif
@@ -9,6 +9,7 @@
  */
 
 #include <QtGui>
+#include <QThreadPool>
 #include <math.h>
 #include "VortexThread.h"
 #include "DataObjects/Coefficient.h"
@@ -17,6 +18,56 @@
 #include "VTD/mgbvtd.h"
 #include "Math/Matrix.h"
 #include "NRL/Hvvp.h"
+#include "IO/StageStats.h"
+#include "Threads/VolumeScheduler.h"
+
+RingFitTask::RingFitTask(const GriddedData* grid, const QVector<CylindricalRing>* rings,
+                         const QString& velField, VTD* vtd, float xCenter, float yCenter,
+                         int numCoeffs)
+{
+    _grid = grid;
+    _rings = rings;
+    _velField = velField;
+    _vtd = vtd;
+    _xCenter = xCenter;
+    _yCenter = yCenter;
+    _numCoeffs = numCoeffs;
+}
+
+RingFitTask::~RingFitTask()
+{
+    delete _vtd;
+}
+
+void RingFitTask::run()
+{
+    int numRings = _rings->size();
+    _coeffs.resize(numRings * _numCoeffs);
+    _fitted.fill(false, numRings);
+
+    GriddedData::FieldHandle velHandle = _grid->getFieldIndex(_velField);
+    QVector<float> data;
+    QVector<float> azimuths;
+    Coefficient buffer[20];
+    Coefficient* vtdCoeffs = buffer;
+    for (int r = 0; r < numRings; r++) {
+        const CylindricalRing& ring = _rings->at(r);
+        data.resize(ring.k.size());
+        azimuths.resize(ring.k.size());
+        float* ringData = data.data();
+        float* ringAzimuths = azimuths.data();
+        int numData = _grid->getCylindricalAzimuthData(velHandle, ring, _xCenter, _yCenter,
+                                                       ringData, ringAzimuths);
+        float radius = ring.radius;
+        float height = ring.height;
+        float stdDev;
+        _fitted[r] = _vtd->analyzeRing(_xCenter, _yCenter, radius, height, numData, ringData,
+                                       ringAzimuths, vtdCoeffs, stdDev);
+        // Keep whatever the VTD left in the buffer, as the serial loop did
+        for (int c = 0; c < _numCoeffs; c++)
+            _coeffs[r * _numCoeffs + c] = buffer[c];
+    }
+}
 
 VortexThread::VortexThread(QObject *parent) : QObject(parent)
 {
@@ -46,11 +97,13 @@ VortexThread::VortexThread(QObject *parent) : QObject(parent)
     pressureList = NULL;
     configData = NULL;
     dataGaps = NULL;
+    hvvpCache = NULL;
 }
 
 VortexThread::~VortexThread()
 {
     delete [] dataGaps;
+    delete hvvpCache;
 }
 
 void VortexThread::getWinds(Configuration *wholeConfig, GriddedData *dataPtr, RadarData *radarPtr,
@@ -79,6 +132,10 @@ void VortexThread::run()
 
     int maxCoeffs = maxWave * 2 + 3;
 
+    // Size the coefficient storage to the rings and wavenumbers retrieved here
+    vortexData->setNumRadii(int(lastRing - firstRing) + 1);
+    vortexData->setNumWaveNum(maxWave + 1);
+
     // Find & Set Average RMW
     float rmw = 0;
     int goodrmw = 0;
@@ -100,6 +157,7 @@ void VortexThread::run()
 
     hvvpResult = 0.0;
 
+    StageTimer hvvpTimer("hvvp");
     if (closure.contains(QString("hvvp"), Qt::CaseInsensitive)) {
       if ( ! calcHVVP(true))
 	emit log(Message(QString(),5,this->objectName(),Yellow,QString("Could Not Retrieve HVVP Wind")));
@@ -107,10 +165,9 @@ void VortexThread::run()
     else {
       emit log(Message(QString(),5,this->objectName()));
     }
+    hvvpTimer.stop();
 
-    vtd = VTDFactory::createVTD(geometry, closure, maxWave, dataGaps,
-				hvvpResult);
-    Coefficient* vtdCoeffs = new Coefficient[20];
+    StageTimer vtdTimer("vtd");
 
     // Placeholders for centers
 
@@ -128,6 +185,15 @@ void VortexThread::run()
     // How do I get simplexData->getNumLevels() from here?
     int maxIndex = (int) floor( (lastLevel - firstLevel) / kGridSpacing + 1.5);
 
+    // Once the center of each level is fixed the levels are independent, so
+    // each level's rings are fitted by its own task and VTD. Results are
+    // archived afterwards in level and ring order.
+    QVector<QVector<CylindricalRing> > levelRings(maxIndex);
+    QVector<RingFitTask*> levelTasks(maxIndex, NULL);
+    QVector<float> levelRt(maxIndex, 0);
+    QThreadPool pool;
+    pool.setMaxThreadCount(VolumeScheduler::threadBudget());
+
     for(storageIndex = 0; storageIndex < maxIndex; storageIndex++) {
 
         float referenceLat = vortexData->getLat(storageIndex);
@@ -153,40 +219,53 @@ void VortexThread::run()
         // compute crossbeam wind to correct GBVTD result
 
         int gradientIndex = heightToIndex(gradientHeight);
-        QDomElement radar = configData->getConfig("radar");
-        float radarLat = configData->getParam(radar,"lat").toFloat();
-        float radarLon = configData->getParam(radar,"lon").toFloat();
+        float radarLat = radarParams.lat;
+        float radarLon = radarParams.lon;
         float vortexLat = vortexData->getLat(gradientIndex);
         float vortexLon = vortexData->getLon(gradientIndex);
 
         float* distance = gridData->getCartesianPoint(&radarLat, &radarLon, &vortexLat, &vortexLon);
         float rt = sqrt(distance[0]*distance[0]+distance[1]*distance[1]);
-        float cca = atan2(distance[0], distance[1])*180/acos(-1);
         delete [] distance;
-
-        Hvvp *hvvp = new Hvvp;
-        hvvp->setConfig(configData);
-        hvvp->setRadarData(radarVolume, rt, cca, vortexData->getAveRMW());
-
-	float Vm = 0.0;
+        levelRt[storageIndex] = rt;
 
         // should we be incrementing radius using ringwidth? -LM
         for (float radius = firstRing; radius <= lastRing; radius++) {
-            // Get the cartesian points
-            xCenter = gridData->getCartesianRefPointI();
-            yCenter = gridData->getCartesianRefPointJ();
+            CylindricalRing ring;
+            gridData->getCylindricalAzimuthRing(radius, height, ring);
+            levelRings[storageIndex].append(ring);
+        }
 
-            // Get the data
-            int numData = gridData->getCylindricalAzimuthLength(radius, height);
-            float* ringData = new float[numData];
-            float* ringAzimuths = new float[numData];
-            gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-            gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
-
-            // Call gbvtd
-            if (vtd->analyzeRing(xCenter, yCenter, radius, height, numData, ringData,
-                                 ringAzimuths, vtdCoeffs, vtdStdDev)) {
-                if (vtdCoeffs[0].getParameter() == "VTC0") {
+        // Get the cartesian points
+        xCenter = gridData->getCartesianRefPointI();
+        yCenter = gridData->getCartesianRefPointJ();
+
+        VTD* levelVTD = VTDFactory::createVTD(geometry, closure, maxWave, dataGaps, hvvpResult);
+        RingFitTask* task = new RingFitTask(gridData, &levelRings[storageIndex], velField, levelVTD,
+                                            xCenter, yCenter, maxCoeffs);
+        task->setAutoDelete(false);
+        levelTasks[storageIndex] = task;
+        pool.start(task);
+    }
+    pool.waitForDone();
+
+    qint64 ringsFitted = 0;
+    qint64 ringsTried = 0;
+    for(storageIndex = 0; storageIndex < maxIndex; storageIndex++) {
+        RingFitTask* task = levelTasks[storageIndex];
+        if (task == NULL)
+            continue;
+	float height = firstLevel + storageIndex * kGridSpacing;
+        float rt = levelRt[storageIndex];
+	float Vm = 0.0;
+
+        for (int r = 0; r < levelRings[storageIndex].size(); r++) {
+            float radius = levelRings[storageIndex].at(r).radius;
+            Coefficient* vtdCoeffs = task->getCoefficients(r);
+            ringsTried++;
+            if (task->isFitted(r)) {
+                ringsFitted++;
+                if (vtdCoeffs[0].getParameterId() == Coefficient::VTC0) {
                     // VT[v] = vtdCoeffs[0].getValue();
                     if(vtdCoeffs[0].getValue() != -999.f){
                         vtdCoeffs[0].setValue( vtdCoeffs[0].getValue()-Vm*radius/rt );
@@ -203,17 +282,17 @@ void VortexThread::run()
                 emit log(Message(err));
             }
 
-            delete[] ringData;
-            delete[] ringAzimuths;
-
             // All done with this radius and height, archive it
             archiveWinds(radius, storageIndex, maxCoeffs, vtdCoeffs);
         }
+        delete task;
     }
+    StageStats::count("vtd_rings", ringsTried);
+    StageStats::count("vtd_rings_fitted", ringsFitted);
+    vtdTimer.stop();
     emit log(Message(QString(),15,this->objectName()));
 
-    // Clean up
-    delete vtd;
+    StageTimer pressureTimer("pressure");
 
     // Integrate the winds to get the pressure deficit at the 2nd level (presumably 2km)
     // Gradient height is in km
@@ -231,10 +310,11 @@ void VortexThread::run()
         vortexData->setAveRMWUncertainty(-999.0);
     }
 
+    pressureTimer.stop();
+
     // Get the estimated surface wind
     getMaxSfcWind(vortexData);
 
-    delete [] vtdCoeffs;
     delete [] pressureDeficit;
 }
 
@@ -291,10 +371,10 @@ void VortexThread::getPressureDeficit(VortexData* data, float* pDeficit,const fl
     // Get coriolis parameter
     float f = 2 * 7.29e-5 * sin(data->getLat(heightIndex) * 3.141592653589793238462643 / 180.);
 
+    int level = data->getHeightIndex(height);
     for (float radius = firstRing; radius <= lastRing; radius++) {
-      // if (!(data->getCoefficient(height, radius, QString("VTC0")) == Coefficient())) {
-      if ( (data->getCoefficient(height, radius, QString("VTC0"))).isValid()) {
-            float meanVT = data->getCoefficient(height, radius, QString("VTC0")).getValue();
+      float meanVT = data->getComponent(level, data->getRingIndex(radius), Coefficient::VTC0);
+      if (meanVT != VortexData::_fillv) {
             if (meanVT != 0) {
                 dpdr[(int)radius] = ((f * meanVT) + (meanVT * meanVT)/(radius * deltar)) * rhoBar[ (int) height - 1];
             }
@@ -339,28 +419,28 @@ void VortexThread::calcCentralPressure(VortexData* vortex, float* pD, float heig
     float pressWeightSum = 0;
     float pressSum = 0;
     numEstimates = 0;
-    float* pressEstimates = new float[pressureList->size()];
-    float* weightEstimates = new float[pressureList->size()];
+    // Only look at the observations near the center in space and time
+    float vortexLat = vortex->getLat(heightIndex);
+    float vortexLon = vortex->getLon(heightIndex);
+    QList<int> candidates = pressureList->findObservations(vortex->getTime(), int(maxObTimeDiff),
+                                                           vortexLat, vortexLon, maxObRadius);
+    float* pressEstimates = new float[candidates.size() + 1];
+    float* weightEstimates = new float[candidates.size() + 1];
 
     // Iterate through the pressure data
     //Message::toScreen("Size of searching List = "+QString().setNum(pressureList->size())+" within time "+QString().setNum(maxObTimeDiff)+" of vortex time "+vortex->getTime().toString(Qt::ISODate));
-    for (int i = 0; i < pressureList->size(); i++) {
+    for (int c = 0; c < candidates.size(); c++) {
+        int i = candidates.at(c);
         float obPressure = pressureList->at(i).getPressure();
 
         if (obPressure > 0) {
             // Check the time
-            QString obTime = pressureList->at(i).getTime().toString(Qt::ISODate);
-            QString vortexTime = vortex->getTime().toString(Qt::ISODate);
             int obTimeDiff = pressureList->at(i).getTime().secsTo(vortex->getTime());
             if ((obTimeDiff > 0) and (obTimeDiff <= maxObTimeDiff)) {
                 // Check the distance
-                float vortexLat = vortex->getLat(heightIndex);
-                float vortexLon = vortex->getLon(heightIndex);
                 float obLat = pressureList->at(i).getLat();
                 float obLon = pressureList->at(i).getLon();
-                float* relDist = gridData->getCartesianPoint(&vortexLat, &vortexLon,&obLat, &obLon);
-                float obRadius = sqrt(relDist[0]*relDist[0] + relDist[1]*relDist[1]);
-                delete [] relDist;
+                float obRadius = GriddedData::getCartesianDistance(vortexLat, vortexLon, obLat, obLon);
                 if ((obRadius >= 20) and (obRadius <= maxObRadius)) {
                 //if ((obRadius >= vortex->getRMW(heightIndex)) and (obRadius <= maxObRadius)) {
                     // Good ob anchor!
@@ -442,11 +522,10 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
     if(nameAddition!=QString())
         nameAddition = nameAddition+QString().setNum(centerStd);
 
-    // Now move this amount of space in each cardinal direction to get 4 additional pressure estimates
-    int numErrorPoints = 4;
+    // Now move this amount of space in evenly spaced directions to get additional pressure estimates
     float angle = 2 * acos(-1) / numErrorPoints;
 
-    // Create a {GB|G}VTD object to process the rings
+    // The HVVP wind is shared by the VTD of every perturbed center
 
     hvvpResult = 0.0;
 
@@ -459,19 +538,26 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
 	emit log(Message(QString(), 0, this->objectName(), Green));
     }
 
-    vtd = VTDFactory::createVTD(geometry, closure, maxWave, dataGaps,
-				hvvpResult);
-
-    Coefficient* vtdCoeffs = new Coefficient[20];
     VortexList errorVertices;
     float refLat = vortexData->getLat(goodLevel);
     float refLon = vortexData->getLon(goodLevel);
     float sqDeficitSum = 0;
 
+    // The ring tables are the same for every perturbed center
+    QVector<CylindricalRing> rings;
+    for (float radius = firstRing; radius <= lastRing; radius++) {
+        CylindricalRing ring;
+        gridData->getCylindricalAzimuthRing(radius, height, ring);
+        rings.append(ring);
+    }
+
+    // Fit the rings around each perturbed center at the same time, each
+    // with its own VTD
+    QThreadPool pool;
+    pool.setMaxThreadCount(VolumeScheduler::threadBudget());
+    QList<RingFitTask*> tasks;
+    QList<int> taskPoints;
     for(int p = 0; p < numErrorPoints; p++) {
-        VortexData* errorVertex = new VortexData(1, vortexData->getNumRadii(), vortexData->getNumWaveNum());
-        errorVertex->setTime(vortexData->getTime().addDays(p).addYears(2));
-        errorVertex->setHeight(0, vortexData->getHeight(goodLevel));
         // Set the reference point
         float* newLatLon = gridData->getAdjustedLatLon(refLat, refLon,
 						       centerStd * cos(p * angle),
@@ -485,33 +571,38 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
             continue;
         }
 
-        for (float radius = firstRing; radius <= lastRing; radius++) {
-            // Get the cartesian points
-            float xCenter = gridData->getCartesianRefPointI();
-            float yCenter = gridData->getCartesianRefPointJ();
-
-            // Get the data
-            int numData = gridData->getCylindricalAzimuthLength(radius, height);
-            float* ringData = new float[numData];
-            float* ringAzimuths = new float[numData];
-
-            gridData->getCylindricalAzimuthData(velField, numData, radius, height, ringData);
-            gridData->getCylindricalAzimuthPosition(numData, radius, height, ringAzimuths);
-
-            // Call gbvtd
-            if (vtd->analyzeRing(xCenter, yCenter, radius, height, numData, ringData, ringAzimuths, vtdCoeffs, vtdStdDev)) {
-                if (vtdCoeffs[0].getParameter() != "VTC0") {
-                    emit log(Message(QString("CalcPressureUncertainty:Error retrieving VTC0 in vortex!"), 0, this->objectName()));
-                }
+        VTD* errorVTD = VTDFactory::createVTD(geometry, closure, maxWave, dataGaps, hvvpResult);
+        RingFitTask* task = new RingFitTask(gridData, &rings, velField, errorVTD,
+                                            gridData->getCartesianRefPointI(),
+                                            gridData->getCartesianRefPointJ(), maxCoeffs);
+        task->setAutoDelete(false);
+        tasks.append(task);
+        taskPoints.append(p);
+        pool.start(task);
+    }
+    pool.waitForDone();
 
-                // All done with this radius and height, archive it
-                archiveWinds(*errorVertex, radius, goodLevel, maxCoeffs, vtdCoeffs);
+    for(int t = 0; t < tasks.size(); t++) {
+        RingFitTask* task = tasks.at(t);
+        int p = taskPoints.at(t);
+        VortexData* errorVertex = new VortexData(1, vortexData->getNumRadii(), vortexData->getNumWaveNum());
+        errorVertex->setTime(vortexData->getTime().addDays(p).addYears(2));
+        errorVertex->setHeight(0, vortexData->getHeight(goodLevel));
 
-                // Clean up
-                delete[] ringData;
-                delete[] ringAzimuths;
+        for (int r = 0; r < rings.size(); r++) {
+            if (!task->isFitted(r))
+                continue;
+            Coefficient* vtdCoeffs = task->getCoefficients(r);
+            if (vtdCoeffs[0].getParameterId() != Coefficient::VTC0) {
+                emit log(Message(QString("CalcPressureUncertainty:Error retrieving VTC0 in vortex!"), 0, this->objectName()));
             }
+
+            // All done with this radius and height, archive it
+            float radius = rings.at(r).radius;
+            archiveWinds(*errorVertex, radius, goodLevel, maxCoeffs, vtdCoeffs);
         }
+        delete task;
+
         // Now calculate central pressure for each of these
         float* errorPressureDeficit = new float[(int)lastRing + 1];
         getPressureDeficit(errorVertex,errorPressureDeficit, height);
@@ -554,9 +645,6 @@ void VortexThread::calcPressureUncertainty(float setLimit, QString nameAddition)
         delete errorVertex;
     }
 
-    delete[] vtdCoeffs;
-    delete vtd;
-
     // Standard deviation from the center point
     float sqPressureSum = 0;
     for(int i = 1; i < errorVertices.count();i++) {
@@ -605,38 +693,45 @@ float VortexThread::indexToHeight(const int index)
 void VortexThread::readInConfig()
 {
     QDomElement vtdConfig = configData->getConfig("vtd");
-    QDomElement pressureConfig = configData->getConfig("pressure");
+    const RingParams vtdParams = configData->getVtdParams();
+    const PressureParams pressureParams = configData->getPressureParams();
+    radarParams = configData->getRadarParams();
 
     vortexPath = configData->getParam(vtdConfig,QString("dir"));
-    geometry = configData->getParam(vtdConfig,QString("geometry"));
+    geometry = vtdParams.geometry;
     refField =  configData->getParam(vtdConfig,QString("reflectivity"));
-    velField = configData->getParam(vtdConfig,QString("velocity"));
-    closure = configData->getParam(vtdConfig,QString("closure"));
+    velField = vtdParams.velocity;
+    closure = vtdParams.closure;
 
-    firstLevel = configData->getParam(vtdConfig,QString("bottomlevel")).toFloat();
-    lastLevel  = configData->getParam(vtdConfig,QString("toplevel")).toFloat();
+    firstLevel = vtdParams.bottomLevel;
+    lastLevel  = vtdParams.topLevel;
 
-    firstRing = configData->getParam(vtdConfig,QString("innerradius")).toFloat();
-    lastRing  = configData->getParam(vtdConfig,QString("outerradius")).toFloat();
+    firstRing = vtdParams.innerRadius;
+    lastRing  = vtdParams.outerRadius;
 
-    ringWidth = configData->getParam(vtdConfig,QString("ringwidth")).toFloat();
-    maxWave = configData->getParam(vtdConfig,QString("maxwavenumber")).toInt();
+    ringWidth = vtdParams.ringWidth;
+    maxWave = vtdParams.maxWaveNumber;
 
     // Define the maximum allowable data gaps
     dataGaps = new float[maxWave+1];
     for (int i = 0; i <= maxWave; i++) {
-        dataGaps[i] = configData->getParam(vtdConfig, QString("maxdatagap"), QString("wavenum"),QString().setNum(i)).toFloat();
+        dataGaps[i] = vtdParams.maxDataGap.value(i);
     }
 
     // Set GriddedData to use ringwidth for spacing
     gridData->setCylindricalAzimuthSpacing(ringWidth);
 
+    // Perturbed centers for the pressure uncertainty, at least 3 are needed
+    numErrorPoints = pressureParams.numErrorPoints;
+    if (numErrorPoints < 3)
+        numErrorPoints = 4;
+
     maxObRadius = 0;
-    maxObTimeDiff = 60 * configData->getParam(pressureConfig, "maxobstime").toFloat();
-    if(configData->getParam(pressureConfig, "maxobsmethod") == "center")
-        maxObRadius = configData->getParam(pressureConfig, "maxobdist").toFloat();
-    if(configData->getParam(pressureConfig, "maxobsmethod") == "ring")
-        maxObRadius = lastRing+configData->getParam(pressureConfig, "maxobsdist").toFloat();
+    maxObTimeDiff = 60 * pressureParams.maxObsTime;
+    if(pressureParams.maxObsMethod == "center")
+        maxObRadius = configData->getParam(configData->getConfig("pressure"), "maxobdist").toFloat();
+    if(pressureParams.maxObsMethod == "ring")
+        maxObRadius = lastRing + pressureParams.maxObsDist;
 
     if(maxObRadius == -999){
         maxObRadius = lastRing + 50;
@@ -646,7 +741,7 @@ void VortexThread::readInConfig()
     }
     // gradientHeight = firstLevel;
     gradientHeight = 2; // Default. There is a "presumably 2km" in a comment in the run() method
-    QString gradientConfig = configData->getParam(pressureConfig, "gradient_height");
+    QString gradientConfig = pressureParams.gradientHeight;
     if(gradientConfig != "")
       gradientHeight = gradientConfig.toFloat();
     if(gradientHeight < firstLevel) {
@@ -654,6 +749,11 @@ void VortexThread::readInConfig()
       std::cout << "Warning: VortexThread gradientHeight adjusted to " << firstLevel << std::endl;
     }
     envPressure = -999;
+
+    hvvpTolerance = 1.0;
+    QString hvvpTolConfig = configData->getParam(configData->getConfig("hvvp"), "tolerance");
+    if(hvvpTolConfig != "")
+      hvvpTolerance = hvvpTolConfig.toFloat();
 }
 
 bool VortexThread::calcHVVP(bool printOutput)
@@ -670,9 +770,8 @@ bool VortexThread::calcHVVP(bool printOutput)
    */
 
     int gradientIndex = heightToIndex(gradientHeight);
-    QDomElement radar = configData->getConfig("radar");
-    float radarLat = configData->getParam(radar,"lat").toFloat();
-    float radarLon = configData->getParam(radar,"lon").toFloat();
+    float radarLat = radarParams.lat;
+    float radarLon = radarParams.lon;
     float vortexLat = vortexData->getLat(gradientIndex);
     float vortexLon = vortexData->getLon(gradientIndex);
 
@@ -691,14 +790,44 @@ bool VortexThread::calcHVVP(bool printOutput)
         //Message::toScreen(hvvpInput);
     }
 
-    Hvvp *envWindFinder = new Hvvp;
-    envWindFinder->setConfig(configData);
-    envWindFinder->setPrintOutput(printOutput);
-    connect(envWindFinder, SIGNAL(log(const Message)),this, SLOT(catchLog(const Message)));
-    envWindFinder->setRadarData(radarVolume,rt, cca, vortexData->getAveRMW());
-    emit log(Message(QString(), 1,this->objectName()));
-    //envWindFinder->findHVVPWinds(false); for first fit only
-    bool hasHVVP = envWindFinder->findHVVPWinds(true);
+    // The layer fits of this volume can be reused if the center has moved
+    // less than hvvpTolerance from the one they were made for
+    float rmw = vortexData->getAveRMW();
+    bool reuse = false;
+    if((hvvpCache != NULL) && (hvvpCache->getVolume() == radarVolume)
+       && (hvvpCacheTime == radarVolume->getDateTimeString())
+       && hvvpCache->hasLayerFits()) {
+        float dcca = (cca - hvvpCacheCca) * acos(-1) / 180;
+        float shift = sqrt(rt * rt + hvvpCacheRt * hvvpCacheRt
+                           - 2 * rt * hvvpCacheRt * cos(dcca));
+        reuse = (shift <= hvvpTolerance) && (fabs(rmw - hvvpCacheRmw) <= hvvpTolerance);
+    }
+
+    Hvvp *envWindFinder = hvvpCache;
+    bool hasHVVP;
+    if(reuse) {
+        envWindFinder->setPrintOutput(printOutput);
+        emit log(Message(QString(), 1,this->objectName()));
+        hasHVVP = envWindFinder->recombine(rt, cca, rmw);
+        StageStats::count("hvvp_reuses", 1);
+    }
+    else {
+        delete hvvpCache;
+        envWindFinder = new Hvvp;
+        envWindFinder->setConfig(configData);
+        envWindFinder->setPrintOutput(printOutput);
+        connect(envWindFinder, SIGNAL(log(const Message)),this, SLOT(catchLog(const Message)));
+        envWindFinder->setRadarData(radarVolume,rt, cca, rmw);
+        emit log(Message(QString(), 1,this->objectName()));
+        //envWindFinder->findHVVPWinds(false); for first fit only
+        hasHVVP = envWindFinder->findHVVPWinds(true);
+        hvvpCache = envWindFinder;
+        hvvpCacheRt = rt;
+        hvvpCacheCca = cca;
+        hvvpCacheRmw = rmw;
+        hvvpCacheTime = radarVolume->getDateTimeString();
+        StageStats::count("hvvp_fits", 1);
+    }
     hvvpResult = envWindFinder->getAvAcrossBeamWinds();
     hvvpUncertainty = envWindFinder->getAvAcrossBeamWindsStdError();
     if(std::isnan(hvvpResult)||(hvvpResult == -999)||
@@ -713,7 +842,6 @@ bool VortexThread::calcHVVP(bool printOutput)
         finalHVVP = QString("Hvvp finds mean wind "+QString().setNum(hvvpResult)+" +/- "+QString().setNum(fabs(hvvpUncertainty)));
 
     emit log(Message(finalHVVP, 0,this->objectName()));
-    delete envWindFinder;
 
     return hasHVVP;
 }
@@ -733,6 +861,7 @@ void VortexThread::getMaxSfcWind(VortexData* data)
         float referenceLat = vortexData->getLat(storageIndex);
         float referenceLon = vortexData->getLon(storageIndex);
 	float height = firstLevel + storageIndex * gridData->getKGridsp();
+	int level = data->getHeightIndex(height);
 
 	// TODO Why would lat and lon be -999?
 	// if ( (referenceLat == -999) || (referenceLon == -999) )
@@ -759,14 +888,14 @@ void VortexThread::getMaxSfcWind(VortexData* data)
 	    // float centerDistance = sqrt(xCenter * xCenter + yCenter * yCenter);
 
             // Get the winds
-	    // if (!(data->getCoefficient(height, radius, QString("VTC0")) == Coefficient())) {
-	    if ( (data->getCoefficient(height, radius, QString("VTC0"))).isValid()) {
-
-	      float vtc0 = data->getCoefficient(height, radius, QString("VTC0")).getValue();
-	      float vrc0 = data->getCoefficient(height, radius, QString("VRC0")).getValue();
-	      float vmc0 = data->getCoefficient(height, radius, QString("VMC0")).getValue();
-	      float vtc1 = data->getCoefficient(height, radius, QString("VTC1")).getValue();
-	      float vts1 = data->getCoefficient(height, radius, QString("VTS1")).getValue();
+	    int ring = data->getRingIndex(radius);
+	    float vtc0 = data->getComponent(level, ring, Coefficient::VTC0);
+	    if (vtc0 != VortexData::_fillv) {
+
+	      float vrc0 = data->getComponent(level, ring, Coefficient::VRC0);
+	      float vmc0 = data->getComponent(level, ring, Coefficient::VMC0);
+	      float vtc1 = data->getComponent(level, ring, Coefficient::VTC1);
+	      float vts1 = data->getComponent(level, ring, Coefficient::VTS1);
 	      double PI = acos(-1.0);
 
 	      for (int i = 0; i < 360; i++) {
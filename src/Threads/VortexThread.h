@@ -13,6 +13,8 @@
 
 #include <QSize>
 #include <QObject>
+#include <QRunnable>
+#include <QVector>
 
 #include "IO/Message.h"
 #include "Config/Configuration.h"
@@ -24,6 +26,36 @@
 #include "Pressure/PressureList.h"
 #include "Radar/RadarData.h"
 
+class Hvvp;
+
+// Fits every ring around one center with its own VTD, so that several
+// centers or levels can be analyzed at once. The CAPPI and ring tables are
+// only read. The coefficients of every ring are kept, isFitted() tells
+// whether the VTD succeeded for it.
+class RingFitTask : public QRunnable
+{
+ public:
+  RingFitTask(const GriddedData* grid, const QVector<CylindricalRing>* rings,
+              const QString& velField, VTD* vtd, float xCenter, float yCenter,
+              int numCoeffs);
+  ~RingFitTask();
+  void run();
+
+  bool isFitted(int ring) const { return _fitted.at(ring); }
+  Coefficient* getCoefficients(int ring) { return _coeffs.data() + ring * _numCoeffs; }
+
+ private:
+  const GriddedData* _grid;
+  const QVector<CylindricalRing>* _rings;
+  QString _velField;
+  VTD* _vtd;
+  float _xCenter;
+  float _yCenter;
+  int _numCoeffs;
+  QVector<Coefficient> _coeffs;
+  QVector<bool> _fitted;
+};
+
 class VortexThread : public QObject
 {
   Q_OBJECT
@@ -53,9 +85,9 @@ class VortexThread : public QObject
      VortexData *vortexData;
      PressureList *pressureList;
      Configuration *configData;
+     RadarParams radarParams;
      
      float* dataGaps;
-     VTD* vtd;
 
      QString vortexPath;
      QString geometry;
@@ -73,9 +105,18 @@ class VortexThread : public QObject
      float maxObTimeDiff;
      float hvvpResult;
      float hvvpUncertainty;
+     // Layer fits of this volume, reused while the center stays within
+     // hvvpTolerance (km) of the one they were made for
+     Hvvp *hvvpCache;
+     float hvvpCacheRt;
+     float hvvpCacheCca;
+     float hvvpCacheRmw;
+     QString hvvpCacheTime;
+     float hvvpTolerance;
      float envPressure;
      float outerRadius;
      int numEstimates;
+     int numErrorPoints;
      QList<PressureData> _presObs;
 
      float vtdStdDev;
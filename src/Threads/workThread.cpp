@@ -15,6 +15,8 @@
 #include "NRL/RadarQC.h"
 #include <unistd.h>
 #include "DataObjects/SimplexList.h"
+#include "DataObjects/VolumeCache.h"
+#include "Threads/VolumeScheduler.h"
 
 workThread::workThread(QObject *parent)
 	: QObject(parent)
@@ -22,6 +24,8 @@ workThread::workThread(QObject *parent)
 	this->setObjectName("Master");
 	abort = false;
 	runOnce = false;
+	// The batch window parents its thread, the GUI does not
+	batchMode = (parent != NULL);
 
 	dataSource= NULL;
 	pressureSource= NULL;
@@ -56,6 +60,10 @@ void workThread::run()
 	loadCenterLocations(configData->getParam(configData->getConfig("vortex"), "centers"));
 
 	QString mode = configData->getParam(configData->getConfig("vortex"), "mode");
+
+	// When several storms share the process, higher priority storms are
+	// analysed first (see VolumeScheduler)
+	int stormPriority = configData->getParam(configData->getConfig("vortex"), "priority").toInt();
 	QDir workingDir(configData->getParam(configData->getConfig("vortex"),"dir"));
 	QString vortexName = configData->getParam(configData->getConfig("vortex"), "name");
 
@@ -91,6 +99,18 @@ void workThread::run()
 	outfile << "# level, radius, param, value" << std::endl;
 	outfile.close();
 
+	// where to save the stage timings and counters of each volume
+	QString statsFilePath = workingDir.filePath(namePrefix + "stagestats.csv");
+	if (!QFile::exists(statsFilePath)) {
+		QFile statsFile(statsFilePath);
+		if (statsFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+			statsFile.write("# volume, kind, name, value\n");
+			statsFile.close();
+		}
+	}
+	StageStats::setActive(&_stageStats);
+	VolumeCache::analysisStarted();
+
 	//create data monitor object
 	dataSource = new RadarFactory(configData);
 	connect(dataSource, SIGNAL(log(const Message&)),this, SLOT(catchLog(const Message&)));
@@ -112,85 +132,90 @@ void workThread::run()
 			dataSource->updateDataQueue(&_vortexList);
 
 			//STEP 2: Select a volume off the queue,try to read it
-			RadarData *newVolume = dataSource->getUnprocessedData();
-			if(newVolume == NULL) {
+			RadarData *freshVolume = dataSource->getUnprocessedData();
+			if(freshVolume == NULL) {
 				continue;
 			}
 
-			emit log(Message("Found file:" + newVolume->getFileName(), -1, this->objectName()));
+			emit log(Message("Found file:" + freshVolume->getFileName(), -1, this->objectName()));
+
+			_stageStats.clear();
+			StageTimer volumeTimer("volume");
 
-			// Check to makes sure that the file still exists and is readable
-			if((!newVolume->fileIsReadable()) or (!newVolume->readVolume())) {
-			  emit log(Message(QString("The radar data file " + newVolume->getFileName() +
-						   " is not readable"), -1, this->objectName()));
-			  delete newVolume;
+			// A volume still coming in only knows its files once they are
+			// all read, so it is read before it can be looked up
+			bool streamed = dataSource->isStreaming();
+			if (streamed && !readVolume(freshVolume)) {
+			  delete freshVolume;
 			  continue;
 			}
+
+			// Other analyses on the same radar share the read and quality
+			// controlled volume, whoever gets to it first prepares it
+			QString volumeKey = VolumeCache::volumeKey(freshVolume->getFileNames(),
+								   configData->getConfig("radar"),
+								   preGridded ? QDomElement()
+								   : configData->getConfig("qc"));
+			QSharedPointer<RadarData> volume = VolumeCache::volumes().claim(volumeKey);
+			if (volume.isNull()) {
+			  if (!prepareVolume(freshVolume, preGridded, !streamed)) {
+			    VolumeCache::volumes().abandon(volumeKey);
+			    delete freshVolume;
+			    continue;
+			  }
+			  volume = QSharedPointer<RadarData>(freshVolume);
+			  VolumeCache::volumes().insert(volumeKey, volume);
+			} else {
+			  delete freshVolume;
+			  StageStats::count("shared_volumes", 1);
+			}
+			RadarData *newVolume = volume.data();
 			std::cout << newVolume->getDateTimeString().toStdString() << ": ";
 
 			// TODO what do we do with that? not needed, will it break anything "volume coverage pattern"
 			emit newVCP(newVolume->getVCP());
 
-			GriddedFactory *gridFactory = new GriddedFactory();
-			GriddedData *gridData;
-
-			if (preGridded) {
+			//STEP 3: get the first guess of center Lat,Lon for simplex
 
-			  gridData = gridFactory->fillPreGriddedData(newVolume, configData);
-			  newVolume->setPreGridded();
+			_latlonFirstGuess(newVolume);
+			QString currentCenter("Processing radar volume at "
+					      + newVolume->getDateTime().toString("hh:mm") + " with ("
+					      + QString().setNum(_firstGuessLat)+ ", "
+					      + QString().setNum(_firstGuessLon)+") center estimate");
+			emit log(Message(currentCenter,1,this->objectName()));
+			if(abort) break;
 
-			  // See if the config wants to overwrite the default max unambiguated range
-			  QDomElement n = configData->getConfig("radar").firstChildElement("max_unambig_range");
-			  if (! n.isNull() ) {
-			    float maxRange = n.text().toFloat();
-			    newVolume->setMaxRange(maxRange);
-			  }
+			// With other storms in the process, wait for our turn. The slot
+			// is held until the volume is done, which also bounds how many
+			// cappis are around at once
+			VolumeSlot volumeSlot(newVolume->getDateTime(), stormPriority);
+			if(abort) break;
 
-			  //STEP 3: get the first guess of center Lat,Lon for simplex
-			  _latlonFirstGuess(newVolume);
-			  QString currentCenter("Processing radar volume at "
-						+ newVolume->getDateTime().toString("hh:mm")
-						+ " with (" + QString().setNum(_firstGuessLat)
-						+ ", "+QString().setNum(_firstGuessLon)+") center estimate");
-			  emit log(Message(currentCenter,1,this->objectName()));
-			  if(abort) break;
+			//STEP 4: from Radardata ---> Griddata, make cappi
+			// An analysis centered on the same spot shares the cappi too
+			QString gridKey = VolumeCache::gridKey(volumeKey, configData->getConfig("cappi"),
+							       _firstGuessLat, _firstGuessLon);
+			QSharedPointer<SharedGrid> grid = VolumeCache::grids().claim(gridKey);
+			if (grid.isNull()) {
+			  GriddedFactory gridFactory;
+			  GriddedData *newGrid;
+			  if (preGridded)
+			    newGrid = gridFactory.fillPreGriddedData(newVolume, configData);
+			  else
+			    newGrid = gridFactory.makeCappi(newVolume, configData, &_firstGuessLat, &_firstGuessLon);
+			  newGrid->writeAsi();
+			  grid = QSharedPointer<SharedGrid>(new SharedGrid(newGrid));
+			  VolumeCache::grids().insert(gridKey, grid);
 			} else {
-
-			  //radar data quality control
-			  RadarQC* dealiaser=new RadarQC(newVolume);
-			  connect(dealiaser,SIGNAL(log(const Message&)),
-				  this,SLOT(catchLog(const Message&)));
-			  dealiaser->getConfig(configData->getConfig("qc"));
-			  dealiaser->dealias();
-			  emit log(Message("Finished QC and Dealiasing",10, this->objectName()));
-			  delete dealiaser;
-			  if(abort) {
-			    delete newVolume;
-			    break;
-			  }
-
-			  //STEP 3: get the first guess of center Lat,Lon for simplex
-
-			  _latlonFirstGuess(newVolume);
-			  QString currentCenter("Processing radar volume at "
-						+ newVolume->getDateTime().toString("hh:mm") + " with ("
-						+ QString().setNum(_firstGuessLat)+ ", "
-						+ QString().setNum(_firstGuessLon)+") center estimate");
-			  emit log(Message(currentCenter,1,this->objectName()));
-			  if(abort) break;
-
-			  //STEP 4: from Radardata ---> Griddata, make cappi
-			  gridData = gridFactory->makeCappi(newVolume, configData, &_firstGuessLat, &_firstGuessLon);
+			  StageStats::count("shared_cappis", 1);
 			}
+			QMutexLocker gridLocker(&grid->inUse);
+			GriddedData *gridData = grid->grid;
 
-			gridData->writeAsi();
 			emit log(Message("Done with Cappi", 15, this->objectName()));
 			emit newCappi(*gridData);
 
 			if(abort) {
-			  delete newVolume;
-			  delete gridFactory;
-			  delete gridData;
 			  break;
 			}
 
@@ -205,9 +230,6 @@ void workThread::run()
 
 			if (runSimplex) {
 			  if ( ! findCenter(newVolume, gridData, bottomLevel, &vortexData, &bestLevel) ) {
-			    delete newVolume;
-			    delete gridFactory;
-			    delete gridData;
 			    continue;
 			  }
 			} else {
@@ -224,23 +246,12 @@ void workThread::run()
 				QList<PressureData>* newObs = pressureSource->getUnprocessedData();
 				// Add any new observations to the list of observations which are used to calculate the current pressure
 				for (int i = newObs->size()-1;i>=0; i--) {
-					bool match = false;
-					for(int j = 0; (!match)&&(j < _pressureList.size()); j++) {
-						if(_pressureList.value(j)==newObs->value(i)) {
-							match = true;
-						}
-					}
-					if(!match) {
-						_pressureList.append(newObs->at(i));
-					}
+					_pressureList.addObservation(newObs->at(i));
 				}
 				delete newObs;
 			}
 
 			if(abort) {
-				delete newVolume;
-				delete gridFactory;
-				delete gridData;
 				break;
 			}
 
@@ -251,8 +262,7 @@ void workThread::run()
 									vortexData->getLat(bestLevel),
 									vortexData->getLon(bestLevel));
 			if (range < newVolume->getMaxUnambig_range()
-			    - configData->getParam(configData->getConfig("center"),
-						   "innerradius").toFloat()) {
+			    - configData->getCenterParams().innerRadius) {
 
 			  emit log(Message("Estimating pressure", 1, this->objectName()));
 
@@ -303,9 +313,7 @@ void workThread::run()
             //STEP 8: finish a round of analysis, clear up
             emit vortexListUpdate(&_vortexList);
             emit log(Message(QString("Completed Analysis On Volume "+newVolume->getFileName()),100,this->objectName()));
-            delete newVolume;
-            delete gridFactory;
-            delete gridData;
+            gridLocker.unlock();
 
         if(abort) break;
 
@@ -314,11 +322,20 @@ void workThread::run()
             _simplexList.saveXML();
             _pressureList.saveXML();
 	    vortexData->saveCoefficients(coeffFilePath);
+
+	    volumeTimer.stop();
+	    QFile statsFile(statsFilePath);
+	    if (statsFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+	      statsFile.write(_stageStats.toCsv(vortexData->getTime().toString(Qt::ISODate)).toLatin1());
+	      statsFile.close();
+	    }
+	    if (batchMode)
+	      emit log(Message("Stage times: " + _stageStats.summary(), 0, this->objectName()));
         } else {
             //if there's no data, have a little rest
             sleep(2);
-            //if in batch mode, abort
-            if (this->parent()){
+            //if in batch mode, abort once no file is still being written
+            if (batchMode && !dataSource->hasPendingData()){
 				std::cout<<"Finished processing all files in batch mode\n";
 	            abort = true;
 	            emit finished();
@@ -326,10 +343,106 @@ void workThread::run()
         }
 
 	} // while ! abort
+    VolumeCache::analysisFinished();
+    StageStats::setActive(NULL);
     delete dataSource;
     delete pressureSource;
 }
 
+// Reads the volume, along with the rest of it when it is still coming in
+
+bool workThread::readVolume(RadarData *radarVolume)
+{
+	// Check to makes sure that the file still exists and is readable
+	bool streamed = dataSource->isStreaming();
+	StageTimer readTimer("read");
+	bool readable = radarVolume->fileIsReadable() and radarVolume->readVolume();
+	readTimer.stop();
+	if (readable && streamed)
+	  readable = streamVolume(radarVolume);
+	if (streamed)
+	  dataSource->finishStreamedVolume(readable);
+	if(!readable) {
+	  emit log(Message(QString("The radar data file " + radarVolume->getFileName() +
+				   " is not readable"), -1, this->objectName()));
+	  return false;
+	}
+	QStringList volumeFiles = radarVolume->getFileNames();
+	for (int f = 0; f < volumeFiles.size(); f++)
+		StageStats::count("bytes_read", QFileInfo(volumeFiles.at(f)).size());
+	return true;
+}
+
+// Gets the volume ready for gridding, quality control and dealiasing
+// unless it comes already gridded. Reads it first unless told it was.
+
+bool workThread::prepareVolume(RadarData *radarVolume, bool preGridded, bool read)
+{
+	if (read && !readVolume(radarVolume))
+		return false;
+
+	if (preGridded) {
+	  radarVolume->setPreGridded();
+
+	  // See if the config wants to overwrite the default max unambiguated range
+	  QDomElement n = configData->getConfig("radar").firstChildElement("max_unambig_range");
+	  if (! n.isNull() ) {
+	    float maxRange = n.text().toFloat();
+	    radarVolume->setMaxRange(maxRange);
+	  }
+	  return true;
+	}
+
+	//radar data quality control
+	RadarQC* dealiaser=new RadarQC(radarVolume);
+	connect(dealiaser,SIGNAL(log(const Message&)),
+		this,SLOT(catchLog(const Message&)));
+	dealiaser->getConfig(configData->getConfig("qc"));
+	dealiaser->dealias();
+	emit log(Message("Finished QC and Dealiasing",10, this->objectName()));
+	delete dealiaser;
+	return !abort;
+}
+
+// Keeps reading the sweeps of a volume that is still coming in, until one
+// of them passes over the top of the cappi. The sweeps above it can't add
+// anything to the grid, so the analysis goes ahead without waiting for
+// the rest of the volume.
+
+bool workThread::streamVolume(RadarData *radarVolume)
+{
+	StageTimer streamTimer("stream_wait");
+	_latlonFirstGuess(radarVolume);
+	float topElevation = CappiGrid::topElevation(radarVolume, configData->getConfig("cappi"),
+						     &_firstGuessLat, &_firstGuessLon);
+	int checkedSweeps = 0;
+	forever {
+		for (; checkedSweeps < radarVolume->getNumSweeps(); checkedSweeps++) {
+			if (radarVolume->getSweep(checkedSweeps)->getElevation() >= topElevation) {
+				StageStats::count("streamed_sweeps", radarVolume->getNumSweeps());
+				return true;
+			}
+		}
+
+		QStringList newFiles;
+		bool open = dataSource->updateStreamedVolume(newFiles);
+		if (!newFiles.isEmpty()) {
+			// The volume is laid out again with the new files, look
+			// at all its sweeps
+			checkedSweeps = 0;
+			radarVolume->addFiles(newFiles);
+			if (!radarVolume->readVolume())
+				return false;
+			continue;
+		}
+		if (!open)
+			return true;
+		if (abort)
+			return false;
+		sleep(2);
+	}
+}
+
 // This slot is used for log message relaying
 // Any objects created by this object must be connected
 // to this slot
@@ -611,8 +724,8 @@ bool workThread::findCenter(RadarData *radar_data, GriddedData *grid_data, float
 {
   emit log(Message("Finding center",1,this->objectName()));
 
-  float radarLat = configData->getParam(configData->getConfig("radar"), "lat").toFloat();
-  float radarLon = configData->getParam(configData->getConfig("radar"), "lon").toFloat();
+  float radarLat = configData->getRadarParams().lat;
+  float radarLon = configData->getRadarParams().lon;
 
   VortexData *vortexData = new VortexData();
 
@@ -706,7 +819,7 @@ bool workThread::findCenter(RadarData *radar_data, GriddedData *grid_data, float
 						    vortexData->getLon(bestLevel));
     if( (userDistance > 25.0f)
 	or (range > radar_data->getMaxUnambig_range() -
-	    configData->getParam(configData->getConfig("center"), "innerradius").toFloat())) {
+	    configData->getCenterParams().innerRadius)) {
       Message newMsg(QString(), 5, this->objectName(),
 		     Yellow, "Center Not Found");
       emit log(newMsg);
@@ -805,18 +918,15 @@ void workThread::updateCappiDisplayInfo(GriddedData *grid_data, VortexData *vort
 					float radar_lat, float radar_lon,
 					float simplex_lat, float simplex_lon)
 {
-  QDomElement simplex = configData->getConfig("center");
-  QDomElement vtd   = configData->getConfig("vtd");
-
   int bestLevel = vortex_data->getBestLevel();
 
   float* xyValues = grid_data->getCartesianPoint(&radar_lat, &radar_lon, &simplex_lat, &simplex_lon);
   float xPercent = float(grid_data->getIndexFromCartesianPointI(xyValues[0])+1)/grid_data->getIdim();
   float yPercent = float(grid_data->getIndexFromCartesianPointJ(xyValues[1])+1)/grid_data->getJdim();
   float rmwEstimate = vortex_data->getRMW(bestLevel)/(grid_data->getIGridsp()*grid_data->getIdim());
-  float sMin = configData->getParam(simplex, "innerradius").toFloat()/(grid_data->getIGridsp()*grid_data->getIdim());
-  float sMax = configData->getParam(simplex, "outerradius").toFloat()/(grid_data->getIGridsp()*grid_data->getIdim());
-  float vMax = configData->getParam(vtd, "outerradius").toFloat()/(grid_data->getIGridsp()*grid_data->getIdim());
+  float sMin = configData->getCenterParams().innerRadius/(grid_data->getIGridsp()*grid_data->getIdim());
+  float sMax = configData->getCenterParams().outerRadius/(grid_data->getIGridsp()*grid_data->getIdim());
+  float vMax = configData->getVtdParams().outerRadius/(grid_data->getIGridsp()*grid_data->getIdim());
   emit newCappiInfo(xPercent, yPercent, rmwEstimate, sMin, sMax, vMax, radar_lat, radar_lon, simplex_lat, simplex_lon);
   delete [] xyValues;
 }
@@ -26,6 +26,7 @@
 #include "Pressure/PressureList.h"
 #include "ChooseCenter.h"
 #include "IO/ATCF.h"
+#include "IO/StageStats.h"
 
 class workThread : public QObject
 {
@@ -39,6 +40,8 @@ public:
     ~workThread();
     void setConfig(Configuration *configPtr) {configData = configPtr;}
     void setATCF(ATCF *atcfPtr) {atcf = atcfPtr;}
+    // In batch mode the thread finishes once no more data is coming
+    void setBatchMode(bool batch) {batchMode = batch;}
     void stop();
     bool findCenter(RadarData *radar_data, GriddedData *grid_data, float bottom_evel,
 		    VortexData **vortex_data, int *best_level);
@@ -69,6 +72,7 @@ signals:
 private:
     
     bool runOnce;
+    bool batchMode;
     volatile bool abort;
     bool continuePreviousRun;
 
@@ -80,10 +84,16 @@ private:
     SimplexList  _simplexList;
     PressureList _pressureList;
 
+    // Stage timings and counters of the volume being processed
+    StageStats _stageStats;
+
     float _firstGuessLat;
     float _firstGuessLon;
     
     void _latlonFirstGuess(RadarData* radarVolume);
+    bool readVolume(RadarData *radarVolume);
+    bool prepareVolume(RadarData *radarVolume, bool preGridded, bool read);
+    bool streamVolume(RadarData *radarVolume);
     void checkIntensification();
     void checkListConsistency();
     void loadCenterLocations(QString centerFile);
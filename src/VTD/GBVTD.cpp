@@ -157,7 +157,7 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
 
     vtdCoeffs[0].setLevel(level);
     vtdCoeffs[0].setRadius(radius);
-    vtdCoeffs[0].setParameter("VTC0");
+    vtdCoeffs[0].setParameterId(Coefficient::VTC0);
     float value;
     if(closure.contains(QString("hvvp"), Qt::CaseInsensitive) and
        (B[1] != 0)) {
@@ -170,19 +170,19 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
 
     vtdCoeffs[1].setLevel(level);
     vtdCoeffs[1].setRadius(radius);
-    vtdCoeffs[1].setParameter("VRC0");
+    vtdCoeffs[1].setParameterId(Coefficient::VRC0);
     value = A[1] +A[3];
     vtdCoeffs[1].setValue(value);
 
     vtdCoeffs[2].setLevel(level);
     vtdCoeffs[2].setRadius(radius);
-    vtdCoeffs[2].setParameter("VMC0");
+    vtdCoeffs[2].setParameterId(Coefficient::VMC0);
     value = A[0] + A[2]+ A[4];
     vtdCoeffs[2].setValue(value);
 
     vtdCoeffs[3].setLevel(level);
     vtdCoeffs[3].setRadius(radius);
-    vtdCoeffs[3].setParameter("VTS1");
+    vtdCoeffs[3].setParameterId(Coefficient::VTS1);
 
     if ((sinAlphamax < 0.8) and (numCoeffs >= 5)) {
       value = A[2] - A[0] + A[4] + (A[0] + A[2] + A[4]) * cosAlphamax;
@@ -197,7 +197,7 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
 
     vtdCoeffs[4].setLevel(level);
     vtdCoeffs[4].setRadius(radius);
-    vtdCoeffs[4].setParameter("VTC1");
+    vtdCoeffs[4].setParameterId(Coefficient::VTC1);
 	
     if ((sinAlphamax < 0.8) and (numCoeffs >= 5)) {
       value = -2. * (B[2] + B[4]);
@@ -213,15 +213,13 @@ void GBVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs,
     for (int i=5; i <= numCoeffs - 1; i += 2) {
       vtdCoeffs[i].setLevel(level);
       vtdCoeffs[i].setRadius(radius);
-      QString param = "VTC" + QString().setNum(int(i / 2));
-      vtdCoeffs[i].setParameter(param);
+      vtdCoeffs[i].setParameterId(Coefficient::makeId(Coefficient::VT, Coefficient::Cos, i / 2));
       value = -2. * B[i / 2 + 1];
       vtdCoeffs[i].setValue(value);
 
       vtdCoeffs[i+1].setLevel(level);
       vtdCoeffs[i+1].setRadius(radius);
-      param = "VTS" + QString().setNum(int(i / 2));
-      vtdCoeffs[i + 1].setParameter(param);
+      vtdCoeffs[i + 1].setParameterId(Coefficient::makeId(Coefficient::VT, Coefficient::Sin, i / 2));
       value = 2 * A[i / 2 + 1];
       vtdCoeffs[i + 1].setValue(value);
     }
@@ -189,14 +189,14 @@ void GVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs, floa
       // Implement GVTD by Ting-Yu Cha 11/03/2017
       vtdCoeffs[0].setLevel(level);
       vtdCoeffs[0].setRadius(radius);
-      vtdCoeffs[0].setParameter("VTC0");
+      vtdCoeffs[0].setParameterId(Coefficient::VTC0);
       float value;
       value = - B[1] - B[3];
       vtdCoeffs[0].setValue(value);
 
       vtdCoeffs[1].setLevel(level);
       vtdCoeffs[1].setRadius(radius);
-      vtdCoeffs[1].setParameter("VRC0");
+      vtdCoeffs[1].setParameterId(Coefficient::VRC0);
       value = (A[0] + A[1] + A[2] + A[3] + A[4]) / ( 1 + radius / centerDistance);
       vtdCoeffs[1].setValue(value);
 
@@ -206,22 +206,20 @@ void GVTD::setWindCoefficients(float& radius, float& level, int& numCoeffs, floa
       for (int i=3; i <= numCoeffs - 1; i += 2) {
 	vtdCoeffs[i].setLevel(level);
 	vtdCoeffs[i].setRadius(radius);
-	QString param = "VTC" + QString().setNum(int(i / 2));
-	vtdCoeffs[i].setParameter(param);
+	vtdCoeffs[i].setParameterId(Coefficient::makeId(Coefficient::VT, Coefficient::Cos, i / 2));
 	value = -2. * B[i / 2 + 1];
 	vtdCoeffs[i].setValue(value);
 
 	vtdCoeffs[i+1].setLevel(level);
 	vtdCoeffs[i+1].setRadius(radius);
-	param = "VTS" + QString().setNum(int(i / 2));
-	vtdCoeffs[i + 1].setParameter(param);
+	vtdCoeffs[i + 1].setParameterId(Coefficient::makeId(Coefficient::VT, Coefficient::Sin, i / 2));
 	value = 2 * A[i / 2 + 1];
 	vtdCoeffs[i + 1].setValue(value);
       }
       
       vtdCoeffs[2].setLevel(level);
       vtdCoeffs[2].setRadius(radius);
-      vtdCoeffs[2].setParameter("VMC0");
+      vtdCoeffs[2].setParameterId(Coefficient::VMC0);
       value = A[0] - ( radius / centerDistance * vtdCoeffs[1].getValue() ) + 0.5 * vtdCoeffs[4].getValue();
       // rhs value is VRC0 value computed just above
       vtdCoeffs[2].setValue(value);
@@ -18,6 +18,9 @@
 
 #include "GUI/MainWindow.h"
 #include "Batch/BatchWindow.h"
+#include "Batch/Benchmark.h"
+#include "Batch/DriverHeadless.h"
+#include "Batch/DriverMultiStorm.h"
 
 void usage(const char *s) {
   std::cout << "Usage: " << std::endl
@@ -29,15 +32,84 @@ void usage(const char *s) {
 	    << std::endl
 	    << "  " << s << " [-g] <config file>.xml (GUI mode with config file on command line)"
     	    << std::endl
+	    << "  " << s << " [-b] <config file>.xml [analytic config].xml (time the analysis on synthetic volumes)"
+    	    << std::endl
+	    << "  " << s << " [-m] [-j slots] [-p newest|priority] <config file>.xml ... (BATCH mode, several storms at once)"
+    	    << std::endl
 	    << std::endl
 	    << "Optional arguments:"
     	    << std::endl
 	    << "  -d: Turn on debug flag"
 	    << std::endl
+	    << "  -r: Batch mode with the CAPPI display (needs a display)"
+	    << std::endl
+	    << "  -j: With -m, number of volumes analyzed at the same time (default 1)"
+	    << std::endl
+	    << "  -p: With -m, which waiting volume goes next: newest (default) or priority"
+	    << std::endl
 	    << "  -h: Display help screen and exit"
     	    << std::endl;
 }
 
+// Make sure the file is a VORTRAC configuration, and create the output
+// folders next to it if they don't exist yet
+
+bool checkConfigFile(const QString &xmlfile)
+{
+    // Check to make sure the argument has the right suffix
+    if (xmlfile.right(3) != "xml") {
+        std::cout << xmlfile.toStdString() << " does not look like an XML file\n";
+        return false;
+    }
+
+    // Open the file
+    QFile file(xmlfile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cout << "Error Opening Configuration File, Check Permissions on " << xmlfile.toStdString() << "\n";
+        return false;
+    }
+
+    // Create a DOM document with contents from the configuration file
+    QDomDocument domDoc;
+    QString errorStr;
+    int errorLine;
+    int errorColumn;
+    if (!domDoc.setContent(&file, true, &errorStr, &errorLine, &errorColumn)) {
+        // Exit on malformed XML
+        QString errorReport = QString("XML Parse Error in "+xmlfile+" at Line %1, Column %2:\n%3")
+        .arg(errorLine)
+        .arg(errorColumn)
+        .arg(errorStr);
+        std::cout << errorReport.toStdString() << "\n";
+        file.close();
+        return false;
+    }
+
+    // Successful file read
+    file.close();
+
+    // Check the root node to make sure this is really a VORTRAC configuration file
+    QDomElement root = domDoc.documentElement();
+    if (root.tagName() != "vortrac") {
+        std::cout << "The XML file " << xmlfile.toStdString() << " is not an VORTRAC configuration file\n.";
+        return false;
+    }
+
+    //Check to see if folders for output exist. If not create them
+
+    QFileInfo fileInfo = QFileInfo(file);
+    QString filePath = fileInfo.absolutePath();
+    std::cout << filePath.toStdString() << "\n";
+    QList<QString> dirnames;
+    dirnames << "cappi" << "pressure" << "center" << "choosecenter" << "vtd";
+    for (int i = 0; i < dirnames.size(); ++i) {
+        if (!QDir(filePath + "/" + dirnames.at(i)).exists()) {
+            QDir().mkdir(filePath + "/" + dirnames.at(i));
+        }
+    }
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     // Increase the size of the stack to account for some of the large 3D array local variables
@@ -60,12 +132,30 @@ int main(int argc, char *argv[])
     char *conf_file_path = NULL;
     bool debug = false;
     bool gui_mode = true;
+    bool benchmark_mode = false;
+    bool render_batch = false;
+    bool multi_mode = false;
+    int volume_slots = 1;
+    QString policy_name("newest");
     
-    while( (opt = getopt(argc, argv, "c:g:hd")) != -1)
+    while( (opt = getopt(argc, argv, "b:c:g:hdrmj:p:")) != -1)
     switch(opt){
+    case 'm':
+      multi_mode = true;
+      gui_mode = false;
+      break;
+    case 'j':
+      volume_slots = atoi(optarg);
+      break;
+    case 'p':
+      policy_name = optarg;
+      break;
     case 'd':
       debug = true;
       break;
+    case 'r':
+      render_batch = true;
+      break;
     case 'c':
       conf_file_path = strdup(optarg);
       gui_mode = false;
@@ -74,13 +164,18 @@ int main(int argc, char *argv[])
       conf_file_path = strdup(optarg);
       gui_mode = true;
       break;
+    case 'b':
+      conf_file_path = strdup(optarg);
+      gui_mode = false;
+      benchmark_mode = true;
+      break;
     case 'h':
     case '?':
       usage(argv[0]);
       exit(0);
     }
 
-    if (debug) {
+    if (debug && conf_file_path != NULL) {
       std::cerr << "==>> conf_file_path: " << conf_file_path << std::endl;
     }
 
@@ -90,7 +185,47 @@ int main(int argc, char *argv[])
     // vortrac -c file.xml <- Batch mode
     // vortrac -c file.xml file1 [file2, ....]
     // vortrac -g file.xml <- GUI mode with config file
-    
+    // vortrac -b file.xml [analytic.xml] <- Benchmark on synthetic volumes
+    // vortrac -m [-j 2] [-p priority] a.xml b.xml ... <- Several storms in one batch
+
+    if (benchmark_mode) {
+      QCoreApplication app(argc, argv);
+      QFileInfo confInfo(conf_file_path);
+      QString analyticFile = confInfo.dir().filePath("vortrac_defaultAnalyticTC.xml");
+      if (optind < argc)
+	analyticFile = argv[optind];
+      Benchmark bench(conf_file_path, analyticFile);
+      if (! bench.run(confInfo.dir().filePath("benchmark.json")))
+	return EXIT_FAILURE;
+      return EXIT_SUCCESS;
+    }
+
+    if (multi_mode) {
+      bool ok;
+      VolumeScheduler::Policy policy = VolumeScheduler::policyFromString(policy_name, &ok);
+      if (!ok || volume_slots < 1 || optind == argc) {
+	usage(argv[0]);
+	return EXIT_FAILURE;
+      }
+      QStringList xmlfiles;
+      for(int index = optind; index < argc; index++) {
+	xmlfiles << QString(argv[index]);
+	if (! checkConfigFile(xmlfiles.last()))
+	  return EXIT_FAILURE;
+      }
+      std::cout << "Multi storm batch mode with " << xmlfiles.size() << " configs" << std::endl;
+      QCoreApplication app(argc,argv);
+      qRegisterMetaType<Message>("Message");
+      qRegisterMetaType<GriddedData>("GriddedData");
+      qRegisterMetaType<VortexList>("VortexList");
+      DriverMultiStorm driver(0, xmlfiles, volume_slots, policy);
+      QObject::connect(&driver, SIGNAL(finished()), &app, SLOT(quit()));
+      if (!driver.initialize())
+	return EXIT_FAILURE;
+      driver.run();
+      return app.exec();
+    }
+
     if (optind == argc) { // All options consumed
       if (gui_mode) {
 	std::cout << "GUI mode" << std::endl;
@@ -117,58 +252,9 @@ int main(int argc, char *argv[])
 
     if (conf_file_path != NULL) {
 
-        // Check to make sure the argument has the right suffix
         QString xmlfile(conf_file_path);
-        if (xmlfile.right(3) != "xml") {
-            std::cout << xmlfile.toStdString() << " does not look like an XML file\n";
-            return EXIT_FAILURE;
-        }
-
-        // Open the file
-        QFile file(xmlfile);
-        if (!file.open(QIODevice::ReadOnly)) {
-            std::cout << "Error Opening Configuration File, Check Permissions on " << xmlfile.toStdString() << "\n";
+        if (! checkConfigFile(xmlfile))
             return EXIT_FAILURE;
-        }
-
-        // Create a DOM document with contents from the configuration file
-        QDomDocument domDoc;
-        QString errorStr;
-        int errorLine;
-        int errorColumn;
-        if (!domDoc.setContent(&file, true, &errorStr, &errorLine, &errorColumn)) {
-            // Exit on malformed XML
-            QString errorReport = QString("XML Parse Error in "+xmlfile+" at Line %1, Column %2:\n%3")
-            .arg(errorLine)
-            .arg(errorColumn)
-            .arg(errorStr);
-            std::cout << errorReport.toStdString() << "\n";
-            file.close();
-            return EXIT_FAILURE;
-        }
-
-        // Successful file read
-        file.close();
-
-        // Check the root node to make sure this is really a VORTRAC configuration file
-        QDomElement root = domDoc.documentElement();
-        if (root.tagName() != "vortrac") {
-            std::cout << "The XML file " << xmlfile.toStdString() << " is not an VORTRAC configuration file\n.";
-            return EXIT_FAILURE;
-        }
-
-         //Check to see if folders for output exist. If not create them
-
-         QFileInfo fileInfo = QFileInfo(file);
-         QString filePath = fileInfo.absolutePath();
-         std::cout << filePath.toStdString() << "\n";
-         QList<QString> dirnames;
-         dirnames << "cappi" << "pressure" << "center" << "choosecenter" << "vtd";
-         for (int i = 0; i < dirnames.size(); ++i) {
-             if (!QDir(filePath + "/" + dirnames.at(i)).exists()) {
-                 QDir().mkdir(filePath + "/" + dirnames.at(i));
-             }
-         }
 
          if (gui_mode) {
 
@@ -183,10 +269,24 @@ int main(int argc, char *argv[])
            // batch mode
            
            std::cout << "Batch Mode started for " << xmlfile.toStdString() << " ...\n";
-           QApplication app(argc,argv);
-           BatchWindow mainWin(0, xmlfile);
-           // TODO Is the batch window meant to be invisible?
-           app.exec();
+           if (render_batch) {
+             QApplication app(argc,argv);
+             BatchWindow mainWin(0, xmlfile);
+             // TODO Is the batch window meant to be invisible?
+             app.exec();
+           } else {
+             // No widgets and no CAPPI images
+             QCoreApplication app(argc,argv);
+             qRegisterMetaType<Message>("Message");
+             qRegisterMetaType<GriddedData>("GriddedData");
+             qRegisterMetaType<VortexList>("VortexList");
+             DriverHeadless driver(0, xmlfile);
+             QObject::connect(&driver, SIGNAL(finished()), &app, SLOT(quit()));
+             if (!driver.initialize())
+               return EXIT_FAILURE;
+             driver.run();
+             return app.exec();
+           }
 
         }
 
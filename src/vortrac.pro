@@ -58,9 +58,11 @@ QMAKE_CXXFLAGS += -std=c++0x
 HEADERS += Threads/workThread.h \
            Threads/SimplexThread.h \
            Threads/VortexThread.h \
+           Threads/VolumeScheduler.h \
            DataObjects/VortexData.h \
            DataObjects/SimplexData.h \
            DataObjects/VortexList.h \
+           DataObjects/VolumeCache.h \
            DataObjects/SimplexList.h \
            DataObjects/Coefficient.h \
            DataObjects/Center.h \
@@ -86,7 +88,10 @@ HEADERS += Threads/workThread.h \
            NRL/Hvvp.h \
            IO/Message.h \
            IO/Log.h \
+           IO/LogWriter.h \
            IO/ATCF.h \
+           IO/FileTracker.h \
+           IO/StageStats.h \
            Radar/DateChecker.h \
            Radar/RadarFactory.h \
            Radar/LevelII.h \
@@ -117,15 +122,20 @@ HEADERS += Threads/workThread.h \
            Radar/FetchRemote.h \
            Batch/DriverBatch.h \
            Batch/BatchWindow.h \
+           Batch/Benchmark.h \
+           Batch/DriverHeadless.h \
+           Batch/DriverMultiStorm.h \
            DriverAnalysis.h
 
 SOURCES += main.cpp \
            Threads/workThread.cpp \
            Threads/SimplexThread.cpp \
            Threads/VortexThread.cpp \
+           Threads/VolumeScheduler.cpp \
            DataObjects/VortexData.cpp \
            DataObjects/SimplexData.cpp \
            DataObjects/VortexList.cpp \
+           DataObjects/VolumeCache.cpp \
            DataObjects/SimplexList.cpp \
            DataObjects/Coefficient.cpp \
            DataObjects/Center.cpp \
@@ -151,7 +161,10 @@ SOURCES += main.cpp \
            NRL/Hvvp.cpp \
            IO/Message.cpp \
            IO/Log.cpp \
+           IO/LogWriter.cpp \
            IO/ATCF.cpp \
+           IO/FileTracker.cpp \
+           IO/StageStats.cpp \
            Radar/DateChecker.cpp \
            Radar/RadarFactory.cpp \
            Radar/LevelII.cpp \
@@ -181,6 +194,9 @@ SOURCES += main.cpp \
            Radar/FetchRemote.cpp \
            Batch/DriverBatch.cpp \
            Batch/BatchWindow.cpp \
+           Batch/Benchmark.cpp \
+           Batch/DriverHeadless.cpp \
+           Batch/DriverMultiStorm.cpp \
            DriverAnalysis.cpp
 
 RESOURCES += vortrac.qrc